@@ -0,0 +1,11 @@
+#pragma once
+/*
+    Compact id of an asset path.
+
+    The resource manager gives every model and texture path it loads an id, the same path always
+    getting the same one for the life of the program. Anything keyed by the asset it draws, like the
+    instance renderers of the scene, hashes and compares the id instead of the path string.
+*/
+#include <cstdint>
+
+typedef uint32_t AssetId;
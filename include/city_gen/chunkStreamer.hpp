@@ -0,0 +1,76 @@
+#pragma once
+/*
+    Streams the chunks of a tiled world in and out of the scene around the camera.
+
+    Chunks within the load radius of the camera are generated on the thread pool with
+    generator::GenerateChunkData, and at most one finished chunk is added to the scene a frame.
+    Chunks that fall behind the unload radius are taken out of the scene and their objects
+    deleted, so memory and frame time stay the same however far the camera flies.
+*/
+#include <generator.hpp>
+
+#include <glm/glm.hpp>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class ChunkStreamer
+{
+private:
+    static ChunkStreamer* pInstance;
+    ChunkStreamer() = default;
+
+    bool active = false;
+    unsigned int seed = 0;
+    // Changed by Start and Stop so chunks still generating for an old world are dropped
+    uint32_t generation = 0;
+    // Distance from the camera to a chunk (on the xz plane) to load it, chunks are unloaded half a chunk further out
+    float loadRadius = chunkSize;
+
+    std::unordered_map<ChunkCoord, CitySceneObjects, ChunkCoordHash> loadedChunks;
+    std::unordered_set<ChunkCoord, ChunkCoordHash> pendingChunks;
+
+    // Chunks finished on the pool, waiting to be added to the scene on the main thread
+    struct FinishedChunk
+    {
+        uint32_t generation;
+        ChunkCoord chunk;
+        CityData city;
+    };
+    std::mutex finishedMutex;
+    std::vector<FinishedChunk> finishedChunks;
+
+    // @brief Distance on the xz plane from a position to the closest point of a chunk
+    static float getChunkDistance(ChunkCoord chunk, const glm::vec3& position);
+
+    // @brief Remove the objects of a chunk from the scene and delete them
+    void releaseChunk(CitySceneObjects& objects);
+    void releaseAllChunks(void);
+
+public:
+    // Singleton
+    ChunkStreamer(ChunkStreamer &other) = delete;
+    void operator=(const ChunkStreamer &) = delete;
+    static ChunkStreamer* getInstance();
+
+    // @brief Start streaming a world, any chunks of the previous world are removed
+    // @args seed_in - seed of the world, 0 for a new world
+    // @returns the seed used
+    unsigned int Start(unsigned int seed_in);
+
+    // @brief Stop streaming and remove every streamed chunk from the scene
+    void Stop(void);
+
+    // @brief Load and unload chunks around the camera, call once a frame from the main thread
+    // @args cameraPosition - position to stream around
+    void Update(const glm::vec3& cameraPosition);
+
+    bool IsActive(void) const { return active; }
+    unsigned int GetSeed(void) const { return seed; }
+    size_t GetLoadedChunkCount(void) const { return loadedChunks.size(); }
+    size_t GetPendingChunkCount(void) const { return pendingChunks.size(); }
+
+    // ImGui handle
+    float& GetLoadRadiusImGui(void) { return loadRadius; }
+};
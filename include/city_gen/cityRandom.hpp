@@ -1,35 +1,96 @@
 #pragma once
+/*
+    Random numbers for the generator.
 
-#include <random>
-// #include <limits>
+    Numbers come from a counter based generator (Squares, Widynski 2020): the n-th number of a
+    stream is a pure function of (seed, stream, n). Any stage can draw numbers in any order or
+    on any thread and still get the same city for a seed, as long as each piece of work owns
+    its own stream or index range.
+*/
+
+#include <cstddef>
+#include <cstdint>
 
 class Random {
 
 public:
 
-    // @brief seed generator, used to seed my rand() for generator.cpp
-    // @returns int - seed
-    static int GenerateSeed(void)
+    // @brief seed generator, used to seed the city streams in generator.cpp
+    // @returns int - seed, never 0 as 0 is used to ask for a new city
+    static int GenerateSeed(void);
+
+    // @brief The counter based generator, returns the index'th number of a stream
+    // @args key - stream key from MakeKey
+    // @args index - position in the stream
+    static inline uint32_t Squares32(uint64_t index, uint64_t key)
+    {
+        uint64_t x, y, z;
+        y = x = index * key; z = y + key;
+        x = x*x + y; x = (x >> 32) | (x << 32);
+        x = x*x + z; x = (x >> 32) | (x << 32);
+        x = x*x + y; x = (x >> 32) | (x << 32);
+        return (x*x + z) >> 32;
+    }
+
+    // @brief Key for a (seed, stream) pair
+    static uint64_t MakeKey(uint32_t seed, uint32_t stream);
+
+    // @brief Seed of one chunk of a tiled world, unrelated to the seeds of its neighbours
+    // @args seed - seed of the world
+    // @args chunkX - chunk coordinate along x
+    // @args chunkZ - chunk coordinate along z
+    // @returns never 0
+    static uint32_t MakeChunkSeed(uint32_t seed, int32_t chunkX, int32_t chunkZ);
+
+    // @brief Map 32 random bits onto [0, 1] inclusive, 24 bits of precision
+    static inline float ToPercentage(uint32_t bits)
     {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<int> distribution(0, INT32_MAX);
-        return distribution(gen);
+        return static_cast<float>(bits >> 8) * (1.0f / 16777215.0f);
     }
+};
+
+
+// A stream of random numbers addressed by (seed, stream, index).
+// Draws advance the index, SetIndex jumps anywhere in the stream so work split
+// into independent ranges (a zone, a road) gets the same numbers whatever order it runs in.
+class RandomStream {
+
+public:
+    // @args seed - master seed of the city
+    // @args stream - index of the stream, different streams of the same seed are unrelated
+    // @args index - position to start drawing from
+    RandomStream(uint32_t seed, uint32_t stream, uint64_t index = 0);
+
+    // @brief Next 32 random bits
+    uint32_t GetUInt(void) { return Random::Squares32(index++, key); }
 
     // @brief Returns an integer between a and b
     // @args a - bound1
     // @args b - bound2
-    // @returns int between upper and lower inclusive
-    static int GetIntBetweenInclusive(int a, int b);
-    
+    // @returns int between a and b, both included, without modulo bias
+    int GetIntBetweenInclusive(int a, int b);
+
     // @brief Returns a float between a and b inclusive
     // @args a - bound1
     // @args b - bound2
-    // @returns float between upper and lower inclusive
-    static float GetFloatBetweenInclusive(float a, float b);
+    float GetFloatBetweenInclusive(float a, float b);
 
     // @brief Return a float between 0 and 1 inclusive
-    static float GetPercentage(void);
-};
+    float GetPercentage(void) { return Random::ToPercentage(GetUInt()); }
 
+    // @brief Fill an array with GetPercentage values, same numbers as calling it count times.
+    // 4 at a time with AVX2 (CITY_GEN_AVX2), one at a time otherwise
+    // @args out - array of at least count floats
+    // @args count - number of values to draw
+    void FillPercentages(float* out, size_t count);
+
+    // @brief Fill an array with GetFloatBetweenInclusive(a, b) values
+    void FillFloatsBetweenInclusive(float* out, size_t count, float a, float b);
+
+    uint64_t GetIndex(void) const { return index; }
+    void SetIndex(uint64_t index_in) { index = index_in; }
+
+private:
+    uint64_t key;
+    uint64_t index;
+};
@@ -51,6 +51,15 @@ extern const char* building_defaultInstancedVertShaderPath;
 // Sun Icon for lights
 extern const char* light_icon_texture;
 
+// Chrome trace of the last GenerateCity, see profiler.hpp
+constexpr const char* generationTracePath = "generation_trace.json";
+
+// Generated cities by generation key, see cityCache.hpp
+constexpr const char* cityCacheDirectory = "city_cache";
+
+// Snapshot saved and loaded from the generator menu, see citySnapshot.hpp
+constexpr const char* citySnapshotPath = "city_snapshot.bin";
+
 constexpr std::array<std::string_view, 6> blueSkyBox = {
     "../assets/textures/skybox/cloudy/bluecloud_ft.jpg",
     "../assets/textures/skybox/cloudy/bluecloud_bk.jpg",
@@ -88,6 +97,19 @@ constexpr std::array<std::string_view, 6> yellowSkyBox = {
 };
 
 const std::string treeSpritePath = "../assets/textures/tree_2_cropped.png";
+
+// Buildings placed by the generator, indexed by CityBuilding::modelIndex
+constexpr std::array<std::string_view, 9> buildingModelPaths = {
+    "../assets/models/Buildings/LowPoly/low_buildingA.obj",
+    "../assets/models/Buildings/LowPoly/low_buildingB.obj",
+    "../assets/models/Buildings/LowPoly/low_buildingC.obj",
+    "../assets/models/Buildings/LowPoly/low_buildingD.obj",
+    "../assets/models/Buildings/LowPoly/low_buildingE.obj",
+    "../assets/models/Buildings/LowPoly/low_buildingF.obj",
+    "../assets/models/Buildings/LowPoly/low_buildingG.obj",
+    "../assets/models/Buildings/LowPoly/low_buildingH.obj",
+    "../assets/models/Buildings/LowPoly/low_buildingI.obj"
+};
 }
 #define SKYBOX_BLUESKY 0
 #define SKYBOX_GREYSKY 1
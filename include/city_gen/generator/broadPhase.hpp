@@ -0,0 +1,29 @@
+#pragma once
+/*
+    Sweep and prune broad phase over xz bounds.
+
+    The boxes are sorted once along x and swept with a list of the boxes still open, any
+    two boxes open at the same time that also overlap on z are a candidate pair. Pairs are
+    stored per box in a flat CSR layout so each box can be handled on its own (and on its
+    own thread) by the narrow phase.
+*/
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// Candidate neighbours of every box, neighbours of box i are
+// neighbours[offsets[i]] to neighbours[offsets[i+1]] in ascending order
+struct BroadPhasePairs
+{
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> neighbours;
+
+    size_t GetPairCount(void) const { return neighbours.size() / 2; }
+};
+
+// @brief Find every pair of boxes whose xz bounds overlap, touching bounds count as overlapping
+// @args min - minimum xz of each box (x, z)
+// @args max - maximum xz of each box (x, z), same size as min
+// @args out - cleared and filled, a box is never its own neighbour
+void SweepAndPrune(const std::vector<glm::vec2>& min, const std::vector<glm::vec2>& max, BroadPhasePairs& out);
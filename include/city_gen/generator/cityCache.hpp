@@ -0,0 +1,31 @@
+#pragma once
+/*
+    On disk cache of generated cities.
+
+    A city is stored under the key of everything it was generated from (generator::GetGenerationKey),
+    so the same key always means the same city and a stale file is never read back. Only what the
+    generator decided is stored: the ends, width and flags of every road, the buildings and the trees.
+    Road geometry, zones, placement areas and the road graph are rebuilt on load from the roads, the
+    same way the generator builds them, which keeps the files small.
+
+    Files are in the native byte order, the cache is meant for the machine that wrote it.
+*/
+#include <cityData.hpp>
+
+#include <cstdint>
+#include <string>
+
+// @brief Cache file of a key in the cache directory (paths::cityCacheDirectory)
+std::string GetCityCachePath(uint64_t key);
+
+// @brief Write a city to the cache, the directory is created if needed
+// @args city - city generated with the key
+// @args key - generation key of the city
+// @returns false if the file could not be written
+bool WriteCityCache(const CityData& city, uint64_t key);
+
+// @brief Read a city back from the cache
+// @args key - generation key of the city wanted
+// @args city - replaced by the cached city on a hit
+// @returns false on a miss, a file that does not match the key or the format is a miss too
+bool ReadCityCache(uint64_t key, CityData& city);
@@ -0,0 +1,52 @@
+#pragma once
+/*
+    Chunks of a tiled world.
+
+    The world is split into square chunks on the xz plane, chunk (x, z) covers
+    [x*chunkSize, (x+1)*chunkSize) along x and [z*chunkSize, (z+1)*chunkSize) along z.
+    Everything in a chunk is generated from (seed, x, z) alone, see generator::GenerateChunkData,
+    so chunks can be generated in any order, dropped and generated again.
+*/
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <functional>
+
+// Same width as the square GenerateCityData places its cities in
+constexpr float chunkSize = 400.0f;
+
+struct ChunkCoord
+{
+    int32_t x;
+    int32_t z;
+
+    bool operator==(const ChunkCoord& other) const { return x == other.x && z == other.z; }
+    bool operator!=(const ChunkCoord& other) const { return !(*this == other); }
+};
+
+struct ChunkCoordHash
+{
+    size_t operator()(const ChunkCoord& chunk) const
+    {
+        return std::hash<int64_t>()((static_cast<int64_t>(chunk.x) << 32) | static_cast<uint32_t>(chunk.z));
+    }
+};
+
+// @brief Chunk a world position is in
+inline ChunkCoord GetChunkCoord(const glm::vec3& position)
+{
+    return {static_cast<int32_t>(glm::floor(position.x / chunkSize)),
+            static_cast<int32_t>(glm::floor(position.z / chunkSize))};
+}
+
+// @brief Minimum xz corner of a chunk (x, z)
+inline glm::vec2 GetChunkMin(ChunkCoord chunk)
+{
+    return {static_cast<float>(chunk.x) * chunkSize, static_cast<float>(chunk.z) * chunkSize};
+}
+
+// @brief Maximum xz corner of a chunk, computed the same way as the minimum of the next chunk so borders match exactly
+inline glm::vec2 GetChunkMax(ChunkCoord chunk)
+{
+    return GetChunkMin({chunk.x + 1, chunk.z + 1});
+}
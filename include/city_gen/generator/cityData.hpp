@@ -0,0 +1,97 @@
+#pragma once
+/*
+    GL free description of a generated city.
+
+    generator::GenerateCityData fills this in without touching the scene, the renderer
+    or an OpenGL context. The scene only creates its GL objects from it once a renderer
+    attaches (generator::PopulateScene), the headless cli writes it out instead.
+*/
+#include <roadGeometry.hpp>
+#include <roadGraph.hpp>
+
+#include <glm/glm.hpp>
+#include <ostream>
+#include <vector>
+
+// One side of a road that buildings and trees can be placed in
+struct CityZone
+{
+    std::array<glm::vec3, 4> vertices;
+    std::vector<PlacementArea> areas;
+    bool usable = true;
+
+    // return a valid placement area, the method will set the use as true and then return position information
+    // @return a const* PlacementArea. If no valid areas returns nullptr
+    PlacementArea const* GetValidPlacement(void)
+    {
+        for (auto& area : areas)
+        {
+            if (!area.isOccupied)
+            {
+                area.isOccupied = true;
+                return &area;
+            }
+        }
+        return nullptr;
+    }
+};
+
+struct CityRoad
+{
+    glm::vec3 a;
+    glm::vec3 b;
+    float width;
+    bool allowBuildingZones = true;
+    bool createTrees = false;
+
+    RoadGeometry geometry;
+    CityZone zoneA; // Left zone
+    CityZone zoneB; // Right zone
+};
+
+// Instance of one of paths::buildingModelPaths
+struct CityBuilding
+{
+    unsigned int modelIndex;
+    glm::vec3 position;
+    float angle;        // Rotation about y
+    glm::vec3 scale;
+};
+
+struct CityTree
+{
+    glm::vec3 position;
+};
+
+struct CityData
+{
+    unsigned int seed = 0;
+    float densityFactor = 0.0f;
+
+    std::vector<CityRoad> roads;
+    std::vector<CityBuilding> buildings;
+    std::vector<CityTree> trees;
+
+    // How the roads connect, edge i is road i. Built by BuildCityRoadGraph
+    RoadGraph graph;
+};
+
+// @brief Build a road and its zones from its two points, the same way RoadObject does
+// @args a - start of the road
+// @args b - end of the road
+// @args width - width of the road
+CityRoad CreateCityRoad(glm::vec3 a, glm::vec3 b, float width);
+
+// @brief Building placed on an area, taller towards the middle of the zone
+// @args area - placement area the building stands on
+// @args modelIndex - index into paths::buildingModelPaths
+CityBuilding CreateCityBuilding(const PlacementArea& area, unsigned int modelIndex);
+
+// @brief Build the graph of the roads of a city, call again after the roads change
+// @args city - city whose graph is rebuilt from its roads
+void BuildCityRoadGraph(CityData* city);
+
+// @brief Write the city as json
+// @args city - the generated city
+// @args stream - output stream to write to
+void WriteCityJson(const CityData& city, std::ostream& stream);
@@ -0,0 +1,112 @@
+#pragma once
+/*
+    Incremental updates of a generated city when one of its roads is edited.
+
+    CalculateValidZones and GenerateBuildings work over the whole city. The editor keeps the
+    grids and building candidates they would build, so an edit only recomputes what its old
+    and new road can reach: the zones that overlap either road, the candidates of the zones that
+    changed and the candidates close enough to those to have been removed by or to have removed
+    them. The zones and buildings left are the same as running the full passes on the edited roads,
+    models included, as both take the model of a building from generator::GetBuildingModelIndex.
+
+    Buildings and trees are identified by a key from the zone and area they stand on, so the
+    caller can match them to its own objects across edits.
+*/
+#include <cityData.hpp>
+#include <satBatch.hpp>
+#include <spatialGrid.hpp>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// What an edit changed
+struct CityEdit
+{
+    std::vector<size_t> zoneRoads;                                  // Roads whose zones were recomputed, their usable flags may have changed
+    std::vector<uint64_t> removedBuildings;
+    std::vector<std::pair<uint64_t, CityBuilding>> addedBuildings;
+    std::vector<uint64_t> removedTrees;
+    std::vector<std::pair<uint64_t, CityTree>> addedTrees;
+};
+
+class CityEditor
+{
+public:
+    // @args city - city from generator::GenerateCityData, copied
+    explicit CityEditor(const CityData& city);
+
+    // @brief Move a road and update the zones and buildings around it
+    // @args roadIndex - index of the road in the city
+    // @args a - new start of the road
+    // @args b - new end of the road
+    // @args width - new width of the road
+    // @returns the zones, buildings and trees that changed. A key can be both removed and added, apply removals first
+    CityEdit UpdateRoad(size_t roadIndex, glm::vec3 a, glm::vec3 b, float width);
+
+    // @brief The edited city, buildings and trees in the same order the generator gives them
+    CityData GetCityData(void) const;
+
+    const CityRoad& GetRoad(size_t roadIndex) const { return city.roads[roadIndex]; }
+    size_t GetRoadCount(void) const { return city.roads.size(); }
+
+    // Buildings and trees by key, in generator order
+    const std::map<uint64_t, CityBuilding>& GetBuildings(void) const { return buildings; }
+    const std::map<uint64_t, CityTree>& GetTrees(void) const { return trees; }
+
+private:
+    // Building candidate, an area picked by SelectBuildingAreas
+    struct Candidate
+    {
+        uint64_t key;
+        PlacementArea area;
+        unsigned int model = 0;     // generator::GetBuildingModelIndex of the area
+        bool alive = false;
+        bool survives = false;
+    };
+
+    CityData city;
+
+    // Precomputed per road for the zone tests
+    std::vector<SATBox> roadBoxes;
+    std::vector<BoundingCircle> roadCircles;
+    SpatialGrid roadGrid;   // Road OBB bounds
+    SpatialGrid zoneGrid;   // Bounds of both zones of a road
+
+    // Candidate slots, a slot is reused once its candidate is removed
+    std::vector<Candidate> candidates;
+    std::vector<uint32_t> freeCandidates;
+    std::vector<std::vector<uint32_t>> zoneCandidates[2]; // [isZoneB][road] -> slots
+    SpatialGrid candidateGrid;
+
+    std::map<uint64_t, CityBuilding> buildings;
+    std::map<uint64_t, CityTree> trees;
+
+    // Building keys order candidates as GenerateBuildings does, all zone A areas then all zone B areas.
+    // Tree keys order trees as GenerateTrees does, road by road
+    static uint64_t buildingKey(size_t roadIndex, bool isZoneB, uint32_t area)
+    {
+        return (static_cast<uint64_t>(isZoneB) << 62) | (static_cast<uint64_t>(roadIndex) << 20) | area;
+    }
+    static uint64_t treeKey(size_t roadIndex, bool isZoneB, uint32_t area)
+    {
+        return (static_cast<uint64_t>(roadIndex) << 21) | (static_cast<uint64_t>(isZoneB) << 20) | area;
+    }
+
+    void getRoadBounds(size_t roadIndex, glm::vec2& min, glm::vec2& max) const;
+    void getZoneBounds(size_t roadIndex, glm::vec2& min, glm::vec2& max) const;
+
+    // @brief Usable flags of both zones of a road from scratch, the same test as CalculateValidZones
+    void calculateZones(size_t roadIndex);
+
+    // @brief Replace the candidates of a zone, the positions of the old and new ones are added to dirty
+    // Buildings of removed candidates are added to the edit if given
+    void replaceCandidates(size_t roadIndex, bool isZoneB, std::vector<glm::vec3>& dirty, CityEdit* edit);
+
+    // @brief Whether a candidate is not removed by a later candidate, the same test as GenerateBuildings
+    bool candidateSurvives(uint32_t slot) const;
+
+    // @brief Trees of a road marked createTrees, keys added to the edit if given
+    void addTrees(size_t roadIndex, CityEdit* edit);
+    void removeTrees(size_t roadIndex, CityEdit* edit);
+};
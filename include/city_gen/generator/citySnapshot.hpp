@@ -0,0 +1,92 @@
+#pragma once
+/*
+    Binary snapshot of a city as it is in the scene.
+
+    Unlike the city cache, which keeps what the generator decided and rebuilds the rest, a snapshot
+    keeps what the renderer needs as flat arrays: the road end points and widths, the zone usability
+    bits, the instance matrices of the buildings grouped by model id (an index into
+    paths::buildingModelPaths) and the tree positions. Every array starts 16 byte aligned at an
+    offset given in the header, so a mapped file is used in place and a model's matrices go to its
+    instance renderer as one block instead of an object per building.
+
+    Files are in the native byte order, the format is bumped whenever the layout changes.
+*/
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Bits of the road zone array
+enum CitySnapshotZoneBits : uint8_t
+{
+    SNAPSHOT_ZONE_A_USABLE = 1 << 0,
+    SNAPSHOT_ZONE_B_USABLE = 1 << 1
+};
+
+// What is written to a snapshot, gathered from the scene
+struct CitySnapshotContents
+{
+    unsigned int seed = 0;
+
+    std::vector<glm::vec3> roadPoints;  // a and b of each road
+    std::vector<float> roadWidths;
+    std::vector<uint8_t> roadZoneBits;  // CitySnapshotZoneBits of each road
+
+    std::vector<std::vector<float>> buildingTransforms; // By model id, 16 floats (column major mat4) per building
+    std::vector<glm::vec3> treePositions;
+};
+
+// @brief Write a snapshot, the file is replaced as a whole so a reader never sees half of one
+// @args path - file to write
+// @args contents - arrays to write, roadWidths and roadZoneBits have one entry per two roadPoints
+// @returns false if the file could not be written
+bool WriteCitySnapshot(const std::string& path, const CitySnapshotContents& contents);
+
+
+// Read only view of a snapshot file mapped into memory, the pointers stay valid until it is closed
+class CitySnapshot
+{
+public:
+    CitySnapshot() = default;
+    ~CitySnapshot();
+    CitySnapshot(const CitySnapshot&) = delete;
+    void operator=(const CitySnapshot&) = delete;
+
+    // @brief Map a snapshot, the one open before is closed
+    // @args path - file to open
+    // @returns false if the file is missing, of another format or its arrays do not fit in it
+    bool Open(const std::string& path);
+
+    // @brief Unmap the file
+    void Close(void);
+
+    unsigned int GetSeed(void) const;
+
+    uint32_t GetRoadCount(void) const;
+    // @returns two points per road, a then b
+    const glm::vec3* GetRoadPoints(void) const;
+    const float* GetRoadWidths(void) const;
+    const uint8_t* GetRoadZoneBits(void) const;
+
+    // @returns number of model ids the file has ranges for
+    uint32_t GetModelCount(void) const;
+    // @brief Instance matrices of the buildings of one model
+    // @args model - model id, less than GetModelCount()
+    // @args count - set to the number of matrices
+    // @returns count * 16 floats, column major mat4s
+    const float* GetBuildingTransforms(uint32_t model, uint32_t* count) const;
+
+    uint32_t GetTreeCount(void) const;
+    const glm::vec3* GetTreePositions(void) const;
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    // Set when the file is mapped, otherwise data points into buffer
+    bool mapped = false;
+    std::vector<char> buffer;
+
+    template<typename T>
+    const T* at(uint64_t offset) const { return reinterpret_cast<const T*>(data + offset); }
+};
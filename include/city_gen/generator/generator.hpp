@@ -0,0 +1,344 @@
+#pragma once
+
+#include <config.hpp>
+#include <cityData.hpp>
+#include <cityRandom.hpp>
+#include <cityChunk.hpp>
+
+#include <string>
+
+#include <limits> // For float inf
+
+// Struct used for recursive road generation based on point and heading
+struct road_gen_point
+{
+    glm::vec3 point;
+    float degreeHeading;
+    bool endNodeUsed = false; // Used for end node road generation
+    bool hasHighway = false; // used for highway generation
+    
+    // Struct definition for the set
+    inline bool operator<(const road_gen_point& rhs) const
+    {
+        if (point.x != rhs.point.x)
+        {
+            return point.x < rhs.point.x;
+        }
+        if (point.y != rhs.point.y)
+        {
+            return point.y < rhs.point.y;
+        }
+        return point.z < rhs.point.z;
+    }
+};
+
+struct LineProperties
+{
+    float xzGradient;
+    float zIntercept;
+};
+
+// Temp struct for holding road data before adding it to the scene
+struct road_gen_road
+{
+    glm::vec3 a;
+    glm::vec3 b;
+    float width;
+    glm::vec3 colour = DEFAULT_ROAD_COLOUR;
+    LineProperties lp;
+    bool allowBuildingZones = true;
+    bool createTrees = false;
+
+    // This gets the stats about the line in the xz plane
+    void UpdateLineProps(void)
+    {
+        // Work out xz gradient
+        float dz = b.z - a.z;
+        float dx = b.x - a.x;
+        // If dx == 0 then we have a vertical line
+        if (dx == 0)
+        {
+            lp.xzGradient = std::numeric_limits<float>::infinity();
+            // No zIntercept
+        }
+        else
+        {
+            lp.xzGradient = dz/dx;
+            lp.zIntercept = a.z - (lp.xzGradient*a.x);
+        }
+    }
+    
+    // To take into tolerance
+    inline bool areAboutEqual(float a, float b)
+    {
+        float tolerance = 0.001; // Need to have float comparison matching of 0.0001
+        return fabs(a-b) < tolerance;
+    }
+
+    // Methods that take into account error
+    inline bool areGreaterThan(const float a, const float b)
+    {
+        // If a is greater than b above the error tolerance
+        float tolerance = 0.001;
+        return (a-b) > tolerance;
+    }
+
+    inline bool areLessThan(const float a, const float b)
+    {
+        float tolerance = 0.001;
+        return (a-b) < -tolerance;
+    }
+
+    bool isIntercepting(const road_gen_road& road)
+    {
+        // Taken from this guy
+        // https://flassari.is/2008/11/line-line-intersection-in-cplusplus/
+
+        float x1 = a.x, x2 = b.x, x3 = road.a.x, x4 = road.b.x;
+        float y1 = a.z, y2 = b.z, y3 = road.a.z, y4 = road.b.z;
+
+        // Some matrix determinant that indicates how parallel
+        float d = (x1 - x2) * (y3 - y4) - (y1 - y2) * (x3 - x4);
+        if (d == 0) return false; // If determinant is zero they are parallel.
+
+        // Get the x and y
+        float pre = (x1*y2 - y1*x2), post = (x3*y4 - y3*x4);
+        float x = ( pre * (x3 - x4) - (x1 - x2) * post ) / d;
+        float y = ( pre * (y3 - y4) - (y1 - y2) * post ) / d;
+
+        // Check if the x and y coordinates are within both lines
+        if ( x < fmin(x1, x2) || x > fmax(x1, x2) ||
+        x < fmin(x3, x4) || x > fmax(x3, x4) ) return false;
+        if ( y < fmin(y1, y2) || y > fmax(y1, y2) ||
+        y < fmin(y3, y4) || y > fmax(y3, y4) ) return false;
+
+        // Now we check that the point of intersection is not at one of the points
+        if ((areAboutEqual(x1, x) && areAboutEqual(y1, y)) ||
+            (areAboutEqual(x2, x) && areAboutEqual(y2, y)) ||
+            (areAboutEqual(x3, x) && areAboutEqual(y3, y)) ||
+            (areAboutEqual(x4, x) && areAboutEqual(y4, y)))
+        {
+            return false;       
+        }
+        // If all of that is passed then we know they intersect
+        return true;
+    }
+
+    // Determines if this line and the passed in line(road) intersect, including the two points of its own
+    bool isInterceptingAndNodes(const road_gen_road& road)
+    {
+        // Taken from this guy
+        // https://flassari.is/2008/11/line-line-intersection-in-cplusplus/
+
+        float x1 = a.x, x2 = b.x, x3 = road.a.x, x4 = road.b.x;
+        float y1 = a.z, y2 = b.z, y3 = road.a.z, y4 = road.b.z;
+
+        // Some matrix determinant that indicates how parallel
+        float d = (x1 - x2) * (y3 - y4) - (y1 - y2) * (x3 - x4);
+        if (d == 0) return false; // If determinant is zero they are parallel.
+
+        // Get the x and y
+        float pre = (x1*y2 - y1*x2), post = (x3*y4 - y3*x4);
+        float x = ( pre * (x3 - x4) - (x1 - x2) * post ) / d;
+        float y = ( pre * (y3 - y4) - (y1 - y2) * post ) / d;
+        
+        // Bounds checking if point lies outside of both lines (not intersecting)
+        // Modified with error
+        if (areLessThan(x, fmin(x1, x2)) || 
+            areGreaterThan(x, fmax(x1, x2)) ||
+            areLessThan(x, fmin(x3, x4)) || 
+            areGreaterThan(x, fmax(x3, x4))) return false;
+        if (areLessThan(y, fmin(y1, y2)) || 
+            areGreaterThan(y, fmax(y1, y2)) ||
+            areLessThan(y, fmin(y3, y4)) || 
+            areGreaterThan(y, fmax(y3, y4))) return false;
+        
+        // Check that if any of the road points are the intersection, if so then return no intersection
+        // Check that the two intersections are not the roads point A and B
+        // y in this case is the z coordinate (im sorry)
+        if ((areAboutEqual(a.x, x) && areAboutEqual(a.z, y)) ||
+             (areAboutEqual(b.x, x) && areAboutEqual(b.z, y)))
+        {
+            return false;
+        }
+           
+        // If all of that is passed then we know they intersect
+        return true;
+    }
+
+
+    // Operator overload for comparison
+    inline bool operator==(const road_gen_road& roadIn)
+    {
+        if ((a == roadIn.a) && (b == roadIn.b) && (width == roadIn.width))
+        {
+            return true;
+        }
+        return false;
+    }
+};
+
+
+// Scene objects created for a city by generator::PopulateScene
+class RoadObject;
+class ModelObject;
+class SpriteObject;
+struct CitySceneObjects
+{
+    std::vector<RoadObject*> roads;
+    std::vector<ModelObject*> buildings;
+    std::vector<SpriteObject*> trees;
+};
+
+
+// What the generator does with two roads that cross
+enum class CrossingPolicy
+{
+    REMOVE,     // The later road is removed, the cities of existing seeds are made this way
+    SPLIT       // Both roads are split at the crossing into a junction
+};
+
+// Parameters forced on GenerateCityData instead of taken from the seed, 0 keeps the seeded value
+// The seed still draws every value so the rest of the city comes from the same numbers
+struct CityGenerationOverrides
+{
+    int numberOfCities = 0;     // 1-6 from the seed
+    int iterations = 0;         // Grammar iterations of every city, 2-5 from the seed
+};
+
+
+namespace generator
+{
+    // Gap between road bounding circles under which the zones of a road are tested against the other road
+    constexpr float zoneCollisionThreshold = 1.0f;
+
+    // Bump when a change to the generator changes the city of a seed, cached cities of older versions are then not used
+    constexpr uint32_t generatorVersion = 2;
+
+
+    // @brief Generate a complete city with a set of randomly generated values and add it to the scene. If seed is zero a new seed will be created
+    // @args seed_in - specify a seed to generate a previous city, 0 to generate a new city
+    // @returns the seed used, (int) if seed_in = 0 then a random seed is returned else the one you inputed is returned
+    int GenerateCity(unsigned int seed_in);
+
+    // @brief Generate a complete city without a scene or an OpenGL context
+    // @args seed_in - specify a seed to generate a previous city, 0 to generate a new city
+    // @args overrides - parameters to force instead of taking them from the seed, used by the benchmarks
+    // @returns the generated roads, zones, buildings and trees. CityData::seed holds the seed used
+    CityData GenerateCityData(unsigned int seed_in, const CityGenerationOverrides& overrides = {});
+
+    // @brief Hash of everything the city of GenerateCityData depends on: the seed, the overrides, the crossing policy,
+    // the loaded grammars and generatorVersion. The same key always gives the same city
+    // @args seed - seed of the city, not 0
+    // @args overrides - overrides the city is generated with
+    uint64_t GetGenerationKey(unsigned int seed, const CityGenerationOverrides& overrides = {});
+
+    // @brief Generate one chunk of a tiled world without a scene or an OpenGL context
+    // The result only depends on (seed, chunk). Roads crossing into a neighbour belong to the chunk
+    // their middle is in and highways are cut at the chunk border, so neighbouring chunks line up
+    // whichever order they are generated in
+    // @args seed - seed of the world, not 0
+    // @args chunk - chunk to generate
+    // @returns the roads, zones, buildings and trees of the chunk. CityData::seed holds the chunk seed
+    CityData GenerateChunkData(unsigned int seed, ChunkCoord chunk);
+
+    // @brief Create the scene objects (and their GL resources) for a generated city
+    // @args city - city generated by GenerateCityData or GenerateChunkData
+    // @args objects - if not null, filled with the objects added so they can be removed again
+    void PopulateScene(const CityData& city, CitySceneObjects* objects = nullptr);
+
+    // @brief Redo the zones, buildings and trees around a road of the last generated city after it was moved
+    // Only what the old and new road can reach is recomputed, see CityEditor. Roads that are not
+    // from the last GenerateCity are ignored
+    // @args road - road already updated with UpdateRoadAndBatch
+    void UpdateEditedRoad(RoadObject* road);
+
+    // @brief Drop what is kept of the last generated city for road edits, call before its objects are removed
+    void ForgetGeneratedCity(void);
+
+    // @brief Drop what is kept of the last generated city if an object is one of its roads, buildings or trees.
+    // Call before the user deletes a single object, edits would otherwise still map a key to it
+    // @args object - road, model or sprite about to be removed from the scene
+    void ForgetGeneratedCityObject(const void* object);
+
+    // @brief Save the roads, buildings and trees in the scene to a snapshot, see citySnapshot.hpp
+    // @args path - file to write
+    // @args seed - seed to store with the city
+    // @returns false if the file could not be written
+    bool SaveCitySnapshot(const std::string& path, unsigned int seed);
+
+    // @brief Add the city of a snapshot to the scene. The buildings are instances without objects, so
+    // the city cannot be edited like a generated one. Clear the scene first
+    // @args path - file to load
+    // @args seed - if not null, set to the seed stored with the city
+    // @returns false if the file could not be opened or is not a snapshot
+    bool LoadCitySnapshot(const std::string& path, unsigned int* seed = nullptr);
+
+
+    // @brief How crossing roads are resolved by every generation after this, REMOVE by default
+    // @args policy - REMOVE keeps the cities of existing seeds, SPLIT keeps both roads as a junction
+    void SetCrossingPolicy(CrossingPolicy policy);
+    CrossingPolicy GetCrossingPolicy(void);
+
+
+    // @brief Method for the road generation pass, uses LSystemGen internally to generate a grammar string
+    // @args StartPos - vector of the start position
+    // @args StartAngle - angle for the network to start
+    // @args Iterations - number of grammar iterations
+    // @args RoadLength - length of the road when generating
+    // @args RoadWidth - width of the roads
+    // @args roadAngleDegrees - the +/- angles when generating from the grammar
+    // @args endNodes - end nodes of this city, filled in by this method
+    // @args random - stream of this city, safe to call for several cities at once as long as each has its own stream
+    // @returns a dynamic array of the roads generated for this city, roads intersecting each other are removed
+    std::vector<road_gen_road> GenerateRoads(glm::vec3 startPos,
+                                             float startAngle, 
+                                             int iterations, 
+                                             float roadLength, 
+                                             float roadWidth, 
+                                             float roadAngleDegrees, 
+                                             std::vector<road_gen_point>* endNodes,
+                                             RandomStream& random); 
+
+    // Axiom, is the string to have the grammar effect
+    // Iterations is amount of iterations on string
+    // Random is the stream the grammar is picked with
+    void LSystemGen(std::string* axiom, uint iterations, RandomStream& random); 
+
+    // @brief Load a grammar file, cities pick from the loaded grammars and the built in ones
+    // Not thread safe, load grammars before generating
+    // @args path - grammar file, format is described in lSystem.hpp
+    // @returns true if the grammar compiled
+    bool LoadGrammar(const std::string& path);
+
+    // Building placement
+    // @brief Marks the zones of the city that collide with other roads as unusable
+    void CalculateValidZones(CityData* city);
+    // @brief Reset the colour of all zones in the scene
+    void ClearZoneCollisions();
+
+    // @brief Creates buildings in zones
+    // @args city - city to place the buildings in, uses CityData::densityFactor
+    void GenerateBuildings(CityData* city);
+
+    // @brief Tree placement along roads that are marked createTrees (highways)
+    // @args city - city to place the trees in, uses CityData::densityFactor
+    void GenerateTrees(CityData* city);
+
+    // @brief Pick the areas of a zone that get a building candidate, before overlapping buildings are removed
+    // Free areas are taken in order and marked as occupied, each zone draws from its own range of the building stream
+    // @args city - city the zone is in, for the seed and density
+    // @args roadIndex - road the zone belongs to
+    // @args isZoneB - zone B (right) of the road, otherwise zone A
+    // @args areaIndices - cleared and filled with indices into the zones areas
+    void SelectBuildingAreas(CityData* city, size_t roadIndex, bool isZoneB, std::vector<uint32_t>& areaIndices);
+
+    // @brief Pick the areas of a zone that get a tree, GenerateTrees does this for roads marked createTrees
+    // @args areaIndices - cleared and filled with indices into the zones areas
+    void SelectTreeAreas(const CityData& city, size_t roadIndex, bool isZoneB, std::vector<uint32_t>& areaIndices);
+
+    // @brief Model of the building on an area, from where the area is rather than its place among the candidates.
+    // GenerateBuildings and the city editor both use it so an edit picks the model a full generation would
+    // @returns index into paths::buildingModelPaths
+    unsigned int GetBuildingModelIndex(size_t roadIndex, bool isZoneB, uint32_t areaIndex);
+};
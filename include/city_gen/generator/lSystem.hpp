@@ -0,0 +1,430 @@
+#pragma once
+/*
+    L-system grammars and streaming expansion.
+
+    Grammars are compiled from text into flat tables: every successor symbol in one array,
+    productions grouped by the symbol they replace and two 256 entry tables (one slot per char)
+    giving the productions of a symbol. Expanding then costs two array reads per symbol.
+    Built in grammars are compiled at compile time (Compile<N>), user grammars at run time
+    from a file (Grammar::LoadFile). Both use the same text format:
+
+        # comment
+        axiom: X
+        X -> F[+X]F[-X]F[-X]F[+X]F      plain rule
+        X : 0.3 -> F[+X]F                stochastic, one of the rules of X is picked by weight (> 0)
+        F(p) -> F(p*0.5)F(p*0.5)         parametric, p is the parameter of the replaced symbol
+
+    A parameter is 1 unless given, it can be a number or p with an optional * and + constant.
+    Rules are separated by new lines or ';'. The brackets of the axiom and of every successor
+    must balance and [ and ] cannot have rules, so the expanded string always balances too.
+
+    Expansion is walked depth first: a symbol with a rule and iterations left is replaced by
+    descending into its successor, anything else is handed to the caller. The caller sees exactly
+    the symbols of the fully expanded string, in order, while memory stays at one frame per iteration.
+*/
+#include <cityRandom.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lsystem
+{
+    // Parameter of a successor symbol, value = scale * (parameter of the replaced symbol) + offset
+    struct ParameterExpression
+    {
+        float scale = 0.0f;
+        float offset = 1.0f;
+
+        constexpr float Evaluate(float parentParameter) const { return scale * parentParameter + offset; }
+    };
+
+    struct Symbol
+    {
+        char symbol = 0;
+        ParameterExpression parameter;
+    };
+
+    struct Production
+    {
+        char predecessor = 0;
+        uint32_t first = 0;     // First successor symbol
+        uint32_t count = 0;     // Number of successor symbols, 0 erases the symbol
+        float weight = 1.0f;    // Relative chance when a symbol has several productions
+    };
+
+    // Everything the expander needs, points into a StaticGrammar or a Grammar
+    struct GrammarView
+    {
+        const Symbol* symbols;
+        const Production* productions;      // Grouped by predecessor
+        const uint16_t* ruleFirst;          // [256] first production of a symbol
+        const uint16_t* ruleCount;          // [256] number of productions of a symbol
+        uint32_t axiomFirst;
+        uint32_t axiomCount;
+    };
+
+
+    // Fixed size grammar that can be built in a constant expression
+    template<size_t Capacity>
+    struct StaticGrammar
+    {
+        std::array<Symbol, Capacity> symbols{};
+        std::array<Production, Capacity> productions{};
+        std::array<uint16_t, 256> ruleFirst{};
+        std::array<uint16_t, 256> ruleCount{};
+        uint32_t symbolCount = 0;
+        uint32_t productionCount = 0;
+        uint32_t axiomFirst = 0;
+        uint32_t axiomCount = 0;
+
+        const char* error = nullptr;
+        size_t errorPosition = 0;
+
+        constexpr void PushSymbol(const Symbol& symbol)
+        {
+            if (symbolCount == Capacity) { SetError("too many symbols for the grammar capacity", 0); return; }
+            symbols[symbolCount++] = symbol;
+        }
+        constexpr void PushProduction(const Production& production)
+        {
+            if (productionCount == Capacity) { SetError("too many rules for the grammar capacity", 0); return; }
+            productions[productionCount++] = production;
+        }
+        constexpr void SetError(const char* message, size_t position)
+        {
+            if (error == nullptr) { error = message; errorPosition = position; }
+        }
+
+        GrammarView View(void) const
+        {
+            return {symbols.data(), productions.data(), ruleFirst.data(), ruleCount.data(), axiomFirst, axiomCount};
+        }
+    };
+
+
+    // Grammar compiled at run time, for grammars loaded from files
+    class Grammar
+    {
+    public:
+        std::vector<Symbol> symbols;
+        std::vector<Production> productions;
+        std::array<uint16_t, 256> ruleFirst{};
+        std::array<uint16_t, 256> ruleCount{};
+        uint32_t symbolCount = 0;
+        uint32_t productionCount = 0;
+        uint32_t axiomFirst = 0;
+        uint32_t axiomCount = 0;
+
+        const char* error = nullptr;
+        size_t errorPosition = 0;
+
+        void PushSymbol(const Symbol& symbol) { symbols.push_back(symbol); symbolCount++; }
+        void PushProduction(const Production& production) { productions.push_back(production); productionCount++; }
+        void SetError(const char* message, size_t position)
+        {
+            if (error == nullptr) { error = message; errorPosition = position; }
+        }
+
+        GrammarView View(void) const
+        {
+            return {symbols.data(), productions.data(), ruleFirst.data(), ruleCount.data(), axiomFirst, axiomCount};
+        }
+
+        // @brief Compile a grammar from its text
+        // @args source - grammar text, see the top of this file
+        // @args name - used in the error log
+        // @returns true if compiled, errors are logged
+        bool Compile(std::string_view source, const std::string& name = "grammar");
+
+        // @brief Load and compile a grammar file
+        // @returns true if loaded and compiled, errors are logged
+        bool LoadFile(const std::string& path);
+    };
+
+
+    // Parsing, shared by the compile time and run time grammars
+    namespace detail
+    {
+        constexpr bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+        constexpr bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+        struct Parser
+        {
+            std::string_view source;
+            size_t position = 0;
+
+            constexpr bool AtEnd(void) const { return position >= source.size(); }
+            constexpr char Peek(void) const { return AtEnd() ? '\0' : source[position]; }
+
+            constexpr void SkipSpaces(void)
+            {
+                while (!AtEnd() && IsSpace(source[position])) { position++; }
+                // Comments run to the end of the line
+                if (Peek() == '#')
+                {
+                    while (!AtEnd() && source[position] != '\n') { position++; }
+                }
+            }
+
+            constexpr bool AtLineEnd(void)
+            {
+                SkipSpaces();
+                return AtEnd() || Peek() == '\n' || Peek() == ';';
+            }
+
+            constexpr bool Match(std::string_view text)
+            {
+                SkipSpaces();
+                if (source.substr(position, text.size()) == text)
+                {
+                    position += text.size();
+                    return true;
+                }
+                return false;
+            }
+
+            constexpr bool ParseNumber(float& value)
+            {
+                SkipSpaces();
+                bool negative = false;
+                if (Peek() == '-' || Peek() == '+') { negative = Peek() == '-'; position++; }
+
+                const size_t start = position;
+                float result = 0.0f;
+                while (IsDigit(Peek())) { result = result * 10.0f + (Peek() - '0'); position++; }
+                if (Peek() == '.')
+                {
+                    position++;
+                    float scale = 0.1f;
+                    while (IsDigit(Peek())) { result += (Peek() - '0') * scale; scale *= 0.1f; position++; }
+                }
+                if (position == start) { return false; }
+
+                value = negative ? -result : result;
+                return true;
+            }
+
+            // Inside the brackets of a parameter: number | p | p*number, each with an optional +/- number
+            constexpr bool ParseExpression(ParameterExpression& expression)
+            {
+                expression = {0.0f, 0.0f};
+                if (Match("p"))
+                {
+                    expression.scale = 1.0f;
+                    if (Match("*") && !ParseNumber(expression.scale)) { return false; }
+                }
+                else if (!ParseNumber(expression.offset)) { return false; }
+
+                SkipSpaces();
+                if (Peek() == '+' || Peek() == '-')
+                {
+                    float constant = 0.0f;
+                    if (!ParseNumber(constant)) { return false; }
+                    expression.offset += constant;
+                }
+                return Match(")");
+            }
+        };
+
+        // Symbols are any printable char except the ones used by the syntax
+        constexpr bool IsSymbol(char c)
+        {
+            return c > ' ' && c <= '~' && c != '(' && c != ')' && c != ';' && c != '#';
+        }
+
+        // Successor or axiom symbols up to the end of the line
+        template<typename Output>
+        constexpr bool ParseSymbols(Parser& parser, Output& out, uint32_t& count)
+        {
+            count = 0;
+            int depth = 0;  // Open brackets
+            while (!parser.AtLineEnd())
+            {
+                const char c = parser.Peek();
+                if (!IsSymbol(c)) { out.SetError("unexpected character", parser.position); return false; }
+                if (c == ']' && depth == 0) { out.SetError("unbalanced brackets, ] without a [", parser.position); return false; }
+                depth += c == '[' ? 1 : c == ']' ? -1 : 0;
+                parser.position++;
+
+                Symbol symbol{c, {}};
+                if (parser.Peek() == '(')
+                {
+                    parser.position++;
+                    if (!parser.ParseExpression(symbol.parameter)) { out.SetError("bad parameter", parser.position); return false; }
+                }
+                out.PushSymbol(symbol);
+                count++;
+            }
+            if (depth != 0) { out.SetError("unbalanced brackets, [ without a ]", parser.position); return false; }
+            return true;
+        }
+
+        template<typename Output>
+        constexpr bool ParseLine(Parser& parser, Output& out, bool& hasAxiom)
+        {
+            if (parser.AtLineEnd()) { return true; }
+
+            if (parser.Match("axiom:"))
+            {
+                out.axiomFirst = out.symbolCount;
+                hasAxiom = true;
+                return ParseSymbols(parser, out, out.axiomCount);
+            }
+
+            // Predecessor, its parameter can only be named p
+            Production production;
+            parser.SkipSpaces();
+            production.predecessor = parser.Peek();
+            if (!IsSymbol(production.predecessor)) { out.SetError("expected a symbol", parser.position); return false; }
+            if (production.predecessor == '[' || production.predecessor == ']') { out.SetError("[ and ] cannot have rules", parser.position); return false; }
+            parser.position++;
+            if (parser.Peek() == '(' && !(parser.Match("(") && parser.Match("p") && parser.Match(")")))
+            {
+                out.SetError("rule parameter must be (p)", parser.position);
+                return false;
+            }
+
+            if (parser.Match(":") && !parser.ParseNumber(production.weight))
+            {
+                out.SetError("expected a weight", parser.position);
+                return false;
+            }
+            // A weight of 0 or less is never picked, or always when it is the last rule
+            if (!(production.weight > 0.0f)) { out.SetError("weight must be positive", parser.position); return false; }
+            if (!parser.Match("->")) { out.SetError("expected ->", parser.position); return false; }
+
+            production.first = out.symbolCount;
+            if (!ParseSymbols(parser, out, production.count)) { return false; }
+            out.PushProduction(production);
+            return true;
+        }
+
+        // Stable sort the productions by predecessor and fill in the 256 entry tables
+        template<typename Output>
+        constexpr void BuildRuleTables(Output& out)
+        {
+            for (uint32_t i = 1; i < out.productionCount; i++)
+            {
+                Production production = out.productions[i];
+                uint32_t j = i;
+                while (j > 0 && static_cast<unsigned char>(out.productions[j-1].predecessor) > static_cast<unsigned char>(production.predecessor))
+                {
+                    out.productions[j] = out.productions[j-1];
+                    j--;
+                }
+                out.productions[j] = production;
+            }
+
+            for (size_t c = 0; c < 256; c++) { out.ruleFirst[c] = 0; out.ruleCount[c] = 0; }
+            for (uint32_t i = 0; i < out.productionCount; i++)
+            {
+                const unsigned char c = static_cast<unsigned char>(out.productions[i].predecessor);
+                if (out.ruleCount[c] == 0) { out.ruleFirst[c] = i; }
+                out.ruleCount[c]++;
+            }
+        }
+
+        template<typename Output>
+        constexpr void CompileInto(std::string_view source, Output& out)
+        {
+            Parser parser{source, 0};
+            bool hasAxiom = false;
+            while (out.error == nullptr)
+            {
+                if (!ParseLine(parser, out, hasAxiom)) { break; }
+                if (parser.AtEnd()) { break; }
+                parser.position++; // '\n' or ';'
+            }
+            if (out.error == nullptr && !hasAxiom) { out.SetError("grammar has no axiom", parser.position); }
+            if (out.error == nullptr) { BuildRuleTables(out); }
+        }
+    };
+
+
+    // @brief Compile a grammar at compile time, check error is nullptr with a static_assert
+    // @args Capacity - maximum number of symbols and of productions
+    template<size_t Capacity>
+    constexpr StaticGrammar<Capacity> Compile(std::string_view source)
+    {
+        StaticGrammar<Capacity> grammar;
+        detail::CompileInto(source, grammar);
+        return grammar;
+    }
+
+
+    // @brief Expand symbols with a grammars rules and pass every symbol of the result to emit, in order
+    // @args grammar - compiled grammar
+    // @args first, last - symbols to start from, usually the axiom of the grammar
+    // @args iterations - number of times the rules are applied
+    // @args random - picks between the productions of stochastic rules, no numbers are drawn for symbols with one rule
+    // @args emit - callable, emit(char symbol, float parameter) is called once for each symbol of the expanded string
+    template<typename Emit>
+    void Expand(const GrammarView& grammar, const Symbol* first, const Symbol* last, unsigned int iterations, RandomStream& random, Emit&& emit)
+    {
+        struct Frame
+        {
+            const Symbol* current;
+            const Symbol* end;
+            float parameter;        // Parameter of the symbol this frame replaced
+            unsigned int iterationsLeft;
+        };
+
+        // One frame per level, allocated once
+        std::vector<Frame> stack;
+        stack.reserve(iterations + 1);
+        stack.push_back({first, last, 1.0f, iterations});
+
+        while (!stack.empty())
+        {
+            Frame& frame = stack.back();
+            if (frame.current == frame.end)
+            {
+                stack.pop_back();
+                continue;
+            }
+
+            const Symbol& symbol = *frame.current++;
+            const float parameter = symbol.parameter.Evaluate(frame.parameter);
+            const unsigned char index = static_cast<unsigned char>(symbol.symbol);
+
+            if (frame.iterationsLeft > 0 && grammar.ruleCount[index] > 0)
+            {
+                const Production* production = grammar.productions + grammar.ruleFirst[index];
+
+                // Stochastic rule, pick by weight
+                if (grammar.ruleCount[index] > 1)
+                {
+                    float total = 0.0f;
+                    for (uint16_t i = 0; i < grammar.ruleCount[index]; i++) { total += production[i].weight; }
+
+                    float pick = random.GetPercentage() * total;
+                    uint16_t chosen = 0;
+                    while (chosen + 1 < grammar.ruleCount[index] && pick >= production[chosen].weight)
+                    {
+                        pick -= production[chosen].weight;
+                        chosen++;
+                    }
+                    production += chosen;
+                }
+
+                // frame is invalidated by the push, read it first
+                const unsigned int iterationsLeft = frame.iterationsLeft - 1;
+                const Symbol* successor = grammar.symbols + production->first;
+                stack.push_back({successor, successor + production->count, parameter, iterationsLeft});
+                continue;
+            }
+            emit(symbol.symbol, parameter);
+        }
+    }
+
+    // @brief Expand the axiom of a grammar, see above
+    template<typename Emit>
+    void Expand(const GrammarView& grammar, unsigned int iterations, RandomStream& random, Emit&& emit)
+    {
+        const Symbol* axiom = grammar.symbols + grammar.axiomFirst;
+        Expand(grammar, axiom, axiom + grammar.axiomCount, iterations, random, emit);
+    }
+};
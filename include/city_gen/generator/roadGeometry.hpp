@@ -0,0 +1,84 @@
+#pragma once
+/*
+    GL free road and zone geometry.
+
+    The renderer (Road, RoadZoneObject) and the headless generator both build
+    their OBBs, zones and placement areas from these functions so a city generated
+    without an OpenGL context matches the one drawn in the scene.
+*/
+#include <glm/glm.hpp>
+#include <array>
+#include <vector>
+
+#include <helper.hpp>
+
+constexpr float buildingCollisionThresholdDetection = 2.82842712475; // sqrt 8
+
+struct PlacementArea
+{
+    glm::vec3 position;
+    bool isOccupied = false;
+    float angle; // direction based on 0 being -Z
+    std::array<glm::vec3, 4> zoneVerticesArray; // For collision
+    // 0 - 5 (zero is low, 5 is high)
+    int deepness = 0; // Value that determines how deep the value is relative to the endes of the road (will give larger houses for ones in the center)
+
+    // Checks if two orienteted rectangles collide, using SAT - seperate axis theorem
+    bool Intersects(const std::array<glm::vec3, 4>& boundingBox) const
+    {
+        return intersectsSAT(zoneVerticesArray, boundingBox);
+    }
+
+    bool TooFarForCollision(const PlacementArea* area_in) const
+    {
+        if (glm::length(position-area_in->position) <= buildingCollisionThresholdDetection)
+        {
+            return false;
+        }
+        return true;
+    }
+};
+
+// Everything the road renderer needs to know about a road on the xz plane
+struct RoadGeometry
+{
+    // 4 vertices that fully encapsulate the road (including the rounded ends)
+    std::array<glm::vec3, 4> obb;
+
+    // Zones either side of the road, the first two vertices of each zone sit on the road edge
+    std::array<glm::vec3, 4> leftZone;
+    std::array<glm::vec3, 4> rightZone;
+};
+
+// @brief Calculate the OBB and the left and right zones of a road
+// @args point_a - start of the road
+// @args point_b - end of the road
+// @args width - diameter of the road
+RoadGeometry CalculateRoadGeometry(glm::vec3 point_a, glm::vec3 point_b, float width);
+
+// @brief Split a zone into the building placement areas along the road
+// @args vertices - zone vertices as given by CalculateRoadGeometry
+// @args width - width of the road the zone belongs to
+std::vector<PlacementArea> CalculatePlacementAreas(const std::array<glm::vec3, 4>& vertices, float width);
+
+// @brief Angle of a zone relative to the x axis
+float CalculateZoneAngle(const std::array<glm::vec3, 4>& vertices);
+
+// Circle around an OBB on the xz plane, centered on the box
+struct BoundingCircle
+{
+    glm::vec3 center;
+    float radius;
+};
+
+// @brief Circle from the center of an OBB to its corners
+BoundingCircle CalculateBoundingCircle(const std::array<glm::vec3, 4>& obb);
+
+// @brief Bounding circle test with circles computed ahead of time, same result as the OBB version below
+bool TooFarForCollision(const BoundingCircle& a, const BoundingCircle& b, const float threshold);
+
+// @brief Cheap bounding circle test to skip SAT on roads that are far apart
+// @args a - first road OBB
+// @args b - second road OBB
+// @args threshold - gap between the two bounding circles to consider too far
+bool TooFarForCollision(const std::array<glm::vec3, 4>& a, const std::array<glm::vec3, 4>& b, const float threshold);
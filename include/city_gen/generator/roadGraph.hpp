@@ -0,0 +1,80 @@
+#pragma once
+/*
+    Planar graph of the generated roads.
+
+    Road endpoints closer than the weld tolerance become one node. Endpoints are binned by their
+    quantized position so welding only compares against the nodes in the neighbouring bins, and
+    welding is linear in the number of roads. Every road is an edge between two nodes, the edges
+    at each node are kept in a flat CSR layout so the roads meeting at a node are found in
+    O(degree) instead of scanning every road.
+*/
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Endpoints closer than this are the same node, well above the float error of generated
+// endpoints and well below the shortest road
+constexpr float roadWeldTolerance = 0.01f;
+
+class RoadGraph
+{
+public:
+    static constexpr uint32_t noNode = UINT32_MAX;
+
+    struct Edge
+    {
+        uint32_t nodeA;
+        uint32_t nodeB;
+    };
+
+    // Neighbour of a node and the edge that leads to it
+    struct Link
+    {
+        uint32_t node;
+        uint32_t edge;
+    };
+
+    // @brief Build the graph of a set of roads, any previous graph is replaced
+    // @args endpoints - both ends of every road, road i goes from endpoints[2i] to endpoints[2i+1]
+    // @args tolerance - endpoints closer than this are welded into one node
+    void Build(const std::vector<glm::vec3>& endpoints, float tolerance = roadWeldTolerance);
+
+    size_t GetNodeCount(void) const { return nodes.size(); }
+    size_t GetEdgeCount(void) const { return edges.size(); }
+
+    // @brief Position of a node, the first endpoint welded into it
+    const glm::vec3& GetNode(uint32_t node) const { return nodes[node]; }
+
+    // @brief Nodes of an edge, edges have the index of the road they were built from
+    const Edge& GetEdge(uint32_t edge) const { return edges[edge]; }
+
+    // @brief Number of roads meeting at a node, 1 is a dead end and 3 or more a junction
+    uint32_t GetDegree(uint32_t node) const { return offsets[node+1] - offsets[node]; }
+
+    // @brief Links of a node, in the order of their edges
+    // for (auto it = graph.LinksBegin(n); it != graph.LinksEnd(n); ++it)
+    const Link* LinksBegin(uint32_t node) const { return links.data() + offsets[node]; }
+    const Link* LinksEnd(uint32_t node) const { return links.data() + offsets[node+1]; }
+
+    // @brief Node an endpoint at position would be welded into
+    // @returns the node, noNode if there is none within the tolerance
+    uint32_t FindNode(const glm::vec3& position) const;
+
+private:
+    float tolerance = roadWeldTolerance;
+
+    std::vector<glm::vec3> nodes;
+    std::vector<Edge> edges;
+    // Links of node n are links[offsets[n]] to links[offsets[n+1]]
+    std::vector<uint32_t> offsets = {0};
+    std::vector<Link> links;
+
+    // Nodes by bin of tolerance size, each bin is a list through nextInBin
+    std::unordered_map<uint64_t, uint32_t> binHeads;
+    std::vector<uint32_t> nextInBin;
+
+    int64_t getBinCoord(float value) const;
+    static uint64_t getBinKey(int64_t x, int64_t z);
+};
@@ -0,0 +1,76 @@
+#pragma once
+/*
+    Batched SAT (separating axis theorem) tests for oriented rectangles on the xz plane.
+
+    intersectsSAT (helper.hpp) recomputes and normalizes the 8 edge normals on every call. Here the
+    corners and normals of each rectangle are computed once (SATBox) and kept in a SoA store, 8 boxes
+    to a block, so one shape can be tested against 8 boxes at a time with AVX2, 4 at a time with SSE,
+    or one at a time with the scalar fallback. Build with -DCITY_GEN_AVX2=ON for the AVX2 kernel.
+
+    Results match intersectsSAT for rectangles with y = 0, which is all the generator makes.
+*/
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Same lenience as projectionOverlap in helper.cpp
+constexpr float satLenience = 0.05f;
+
+// Corners and normalized edge normals of a rectangle
+struct SATBox
+{
+    float cornerX[4];
+    float cornerZ[4];
+    float normalX[4];
+    float normalZ[4];
+};
+
+// @brief Precompute the corners and edge normals of a rectangle
+// @args vertices - corners in order around the rectangle, as used by intersectsSAT
+SATBox MakeSATBox(const std::array<glm::vec3, 4>& vertices);
+
+// Eight boxes in SoA form, [corner or edge][lane]
+struct alignas(32) SATBoxBlock
+{
+    static constexpr int lanes = 8;
+
+    float cornerX[4][lanes];
+    float cornerZ[4][lanes];
+    float normalX[4][lanes];
+    float normalZ[4][lanes];
+
+    void Set(int lane, const SATBox& box);
+};
+
+// Precomputed boxes kept as SATBoxBlocks, box i is lane i%8 of block i/8
+class SATBoxStore
+{
+public:
+    void Clear(void) { blocks.clear(); count = 0; }
+    void Reserve(size_t boxCount) { blocks.reserve((boxCount + SATBoxBlock::lanes - 1) / SATBoxBlock::lanes); }
+
+    void Add(const SATBox& box);
+    size_t Size(void) const { return count; }
+
+    // @brief Copy up to 8 boxes into one block so they can be tested together
+    // @args indices - boxes to gather
+    // @args indexCount - number of indices, at most 8
+    // @args out - lane l holds box indices[l]
+    void Gather(const uint32_t* indices, int indexCount, SATBoxBlock& out) const;
+
+private:
+    std::vector<SATBoxBlock> blocks;
+    size_t count = 0;
+};
+
+// @brief Test one shape against the boxes of a block
+// @args shape - precomputed shape
+// @args block - boxes to test against
+// @args laneCount - number of lanes in use, the rest are ignored
+// @returns bit l is set if the shape intersects the box in lane l
+uint32_t IntersectsSATBatch(const SATBox& shape, const SATBoxBlock& block, int laneCount);
+
+// @brief Scalar test of two precomputed boxes, same result as a lane of IntersectsSATBatch
+bool IntersectsSAT(const SATBox& a, const SATBox& b);
@@ -0,0 +1,92 @@
+#pragma once
+/*
+    Bounding volume hierarchy over xz segments.
+
+    Built once over the bounds of a set of segments by splitting them at the median of their
+    centres along the longer axis until a leaf holds a few segments. A query only walks down the
+    nodes a segment passes through, so finding the roads a long road may cross is logarithmic in
+    the number of roads instead of a scan over all of them or over every grid cell it overlaps.
+*/
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+class SegmentBVH
+{
+public:
+    // @brief Build the hierarchy, any previous one is replaced
+    // @args min - minimum xz of each segment (x, z), padded by the caller for its intersection tolerance
+    // @args max - maximum xz of each segment (x, z), same size as min
+    void Build(const std::vector<glm::vec2>& min, const std::vector<glm::vec2>& max);
+
+    // @brief Visit the segments whose bounds the segment a-b passes through, until visit returns true.
+    // Nodes nearer a are visited first
+    // @args visit - called with the index of each segment, return true to stop the query
+    // @returns true if visit stopped the query
+    template<typename Visit>
+    bool Query(glm::vec2 a, glm::vec2 b, Visit&& visit) const;
+
+    size_t GetSegmentCount(void) const { return segments.size(); }
+
+private:
+    // Leaves hold segments[first] to segments[first+count], inner nodes have a count of 0 and
+    // their children at nodes[first] and nodes[first+1]
+    struct Node
+    {
+        glm::vec2 min;
+        glm::vec2 max;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    static constexpr uint32_t leafSize = 4;
+    // Balanced by the median split, 64 levels is far more than 2^32 segments need
+    static constexpr uint32_t maxDepth = 64;
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> segments;
+
+    void build(uint32_t node, uint32_t first, uint32_t count, const std::vector<glm::vec2>& min,
+               const std::vector<glm::vec2>& max, const std::vector<glm::vec2>& centres);
+
+    // Slab test of a segment against a box, touching counts as passing through
+    static bool passesThrough(glm::vec2 a, glm::vec2 b, glm::vec2 min, glm::vec2 max);
+};
+
+
+template<typename Visit>
+bool SegmentBVH::Query(glm::vec2 a, glm::vec2 b, Visit&& visit) const
+{
+    if (nodes.empty())
+        return false;
+
+    uint32_t stack[maxDepth * 2];
+    uint32_t stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0)
+    {
+        const Node& node = nodes[stack[--stackSize]];
+        if (!passesThrough(a, b, node.min, node.max))
+            continue;
+
+        // Nearer child first, a query that stops early usually stops on a segment close to a
+        if (node.count == 0)
+        {
+            const Node& left = nodes[node.first];
+            const Node& right = nodes[node.first + 1];
+            const glm::vec2 toLeft = (left.min + left.max) * 0.5f - a, toRight = (right.min + right.max) * 0.5f - a;
+            const bool leftFirst = glm::dot(toLeft, toLeft) <= glm::dot(toRight, toRight);
+            stack[stackSize++] = leftFirst ? node.first + 1 : node.first;
+            stack[stackSize++] = leftFirst ? node.first : node.first + 1;
+            continue;
+        }
+
+        for (uint32_t i = node.first; i < node.first + node.count; i++)
+        {
+            if (visit(segments[i]))
+                return true;
+        }
+    }
+    return false;
+}
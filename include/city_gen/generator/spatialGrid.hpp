@@ -0,0 +1,61 @@
+#pragma once
+/*
+    Uniform grid over the xz plane used by the generator to avoid all-pairs tests.
+
+    Objects are referred to by an index into whatever array the caller owns, an object
+    is stored in every cell its xz bounds overlap. The grid is hashed so it has no fixed
+    extent, cities can be placed anywhere.
+*/
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class SpatialGrid
+{
+public:
+    // @args cellSize - width of a (square) cell in world units, around the size of the objects inserted works best
+    explicit SpatialGrid(float cellSize);
+
+    // @brief Add an object to every cell its bounds overlap
+    // @args id - index of the object in the callers array
+    // @args min - minimum xz of the bounds (x, z)
+    // @args max - maximum xz of the bounds (x, z)
+    void Insert(uint32_t id, glm::vec2 min, glm::vec2 max);
+
+    // @brief Remove an object, bounds must be the same as the ones it was inserted with
+    void Remove(uint32_t id, glm::vec2 min, glm::vec2 max);
+
+    // @brief Get all objects in the cells overlapping the bounds
+    // @args out - cleared and filled with the ids, each id appears once and in ascending order
+    void Query(glm::vec2 min, glm::vec2 max, std::vector<uint32_t>& out) const;
+
+    void Clear(void);
+
+    float GetCellSize(void) const { return cellSize; }
+
+private:
+    using CellKey = int64_t;
+
+    CellKey GetKey(int32_t x, int32_t z) const
+    {
+        return (static_cast<int64_t>(x) << 32) | static_cast<uint32_t>(z);
+    }
+
+    int32_t GetCellCoord(float value) const
+    {
+        return static_cast<int32_t>(glm::floor(value * invCellSize));
+    }
+
+    float cellSize;
+    float invCellSize;
+    std::unordered_map<CellKey, std::vector<uint32_t>> cells;
+};
+
+// @brief xz bounds of a segment for the grid
+inline void GetSegmentBoundsXZ(const glm::vec3& a, const glm::vec3& b, float padding, glm::vec2& min, glm::vec2& max)
+{
+    min = {glm::min(a.x, b.x) - padding, glm::min(a.z, b.z) - padding};
+    max = {glm::max(a.x, b.x) + padding, glm::max(a.z, b.z) + padding};
+}
@@ -10,3 +10,5 @@
 bool projectionOverlap(const std::array<glm::vec3, 4>& a, const std::array<glm::vec3, 4>& b, const glm::vec3 axis);
 glm::vec3 getPerpendicularXZ(glm::vec3 vector);
 
+// Checks if two oriented rectangles collide using the edge normals of both as the seperating axes
+bool intersectsSAT(const std::array<glm::vec3, 4>& a, const std::array<glm::vec3, 4>& b);
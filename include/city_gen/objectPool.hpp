@@ -0,0 +1,123 @@
+#pragma once
+/*
+    Typed pool for the objects the scene creates.
+
+    Objects are built in blocks of BlockSize slots allocated in one go, so objects created one after
+    another (the roads, buildings and trees of a city) sit next to each other in memory instead of
+    wherever the heap puts each one. Addresses stay valid until the object is released, the scene
+    and everything holding its objects keep plain pointers.
+
+    Clear destroys every object still in the pool, including ones unlinked from the scene but never
+    released, and keeps the blocks for the next city. The destructors still run, the objects own GL
+    buffers, but the memory of the objects themselves is not handed back to the heap one at a time.
+*/
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+template<class T, size_t BlockSize = 256>
+class ObjectPool
+{
+private:
+    // storage is the first member so a T* is also the address of its slot
+    struct Slot
+    {
+        alignas(T) unsigned char storage[sizeof(T)];
+        bool alive = false;
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> blocks;
+    std::vector<Slot*> freeSlots;
+    size_t currentBlock = 0;    // Block new slots are taken from
+    size_t usedInBlock = 0;     // Slots of currentBlock handed out so far
+    size_t liveCount = 0;
+
+    Slot* takeSlot(void)
+    {
+        if (!freeSlots.empty())
+        {
+            Slot* slot = freeSlots.back();
+            freeSlots.pop_back();
+            return slot;
+        }
+        if (usedInBlock == BlockSize || blocks.empty())
+        {
+            // Blocks kept by Clear are used again before a new one is allocated
+            if (!blocks.empty()) { currentBlock++; }
+            if (currentBlock == blocks.size()) { blocks.push_back(std::make_unique<Slot[]>(BlockSize)); }
+            usedInBlock = 0;
+        }
+        return &blocks[currentBlock][usedInBlock++];
+    }
+
+public:
+    ObjectPool() = default;
+    ~ObjectPool() { Clear(); }
+    ObjectPool(const ObjectPool&) = delete;
+    void operator=(const ObjectPool&) = delete;
+
+    // @brief Construct an object in the pool
+    // @args args - constructor arguments of T
+    // @returns the object, owned by the pool until Release or Clear
+    template<typename... Args>
+    T* Create(Args&&... args)
+    {
+        Slot* slot = takeSlot();
+        T* object;
+        try
+        {
+            object = new (slot->storage) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            freeSlots.push_back(slot);
+            throw;
+        }
+        slot->alive = true;
+        liveCount++;
+        return object;
+    }
+
+    // @brief Destroy one object, its slot is used by a later Create
+    // @args object - object created by this pool
+    void Release(T* object)
+    {
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        assert(slot->alive);
+        object->~T();
+        slot->alive = false;
+        freeSlots.push_back(slot);
+        liveCount--;
+    }
+
+    // @brief Destroy every object in the pool, the memory is kept for the next objects
+    void Clear(void)
+    {
+        if (liveCount != 0)
+        {
+            for (size_t block = 0; block < blocks.size() && block <= currentBlock; block++)
+            {
+                const size_t used = block == currentBlock ? usedInBlock : BlockSize;
+                for (size_t i = 0; i < used; i++)
+                {
+                    Slot& slot = blocks[block][i];
+                    if (slot.alive)
+                    {
+                        reinterpret_cast<T*>(slot.storage)->~T();
+                        slot.alive = false;
+                    }
+                }
+            }
+        }
+        freeSlots.clear();
+        currentBlock = 0;
+        usedInBlock = 0;
+        liveCount = 0;
+    }
+
+    // @returns number of objects alive in the pool
+    size_t size(void) const { return liveCount; }
+};
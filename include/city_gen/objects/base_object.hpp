@@ -29,6 +29,7 @@ protected:
     float scaleScalar = 1.0f;                   // Float to scale object in all directions
     bool isVisible = true;                      // Visability Flag
     bool isSelectable = true;                  // flag to allow mouse selection
+    size_t instanceIndex = noInstanceIndex;     // Slot in the instance renderer drawing the object, kept by the renderer
 
 
     BaseObject();
@@ -45,8 +46,20 @@ protected:
     glm::mat4 getScaleMat4(glm::vec2 scale) const; // For sprites
     glm::mat4 getScaleMat4(float scale) const;
 public:
+    static constexpr size_t noInstanceIndex = static_cast<size_t>(-1);
+
     float GetDistanceFromCamera() const;
 
+    // Handle of the object in its instance renderer, noInstanceIndex when it is not in one
+    inline size_t GetInstanceIndex(void) const
+    {
+        return instanceIndex;
+    }
+    inline void SetInstanceIndex(size_t index)
+    {
+        instanceIndex = index;
+    }
+
     void SetAlias(const std::string* alias_in)
     {
         alias = *alias_in;
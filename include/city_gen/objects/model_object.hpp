@@ -1,6 +1,8 @@
 #pragma once
 
 #include <base_object.hpp>
+#include <transformStore.hpp>
+#include <assetId.hpp>
 
 // Forward declarations
 class Model;
@@ -35,6 +37,8 @@ public:
     void DrawBoundingBox(glm::vec3 colour = WHITE);
 
     glm::mat4 GetModelMatrix(void);
+    // @brief What the model matrix is built from, kept by the instance renderer
+    InstanceTransform GetInstanceTransform(void) const;
 
     // For builder, these are object specific as we want to return
     // the object type and also it means we can choose for different
@@ -63,6 +67,7 @@ public:
     glm::vec3 GetScale() const;
     std::string GetModelName() const;
     std::string GetModelPath() const;
+    AssetId GetModelAssetId() const;
     bool GetShowBoundingBox() const;
     bool GetIsInstanceRendered(void) const;
     BoundingBox* GetBoundingBox(void) const;
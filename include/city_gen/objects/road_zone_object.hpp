@@ -3,54 +3,7 @@
 #include <zone.hpp>
 #include <config.hpp>
 #include <helper.hpp>
-
-constexpr float buildingCollisionThresholdDetection = 2.82842712475; // sqrt 8
-struct PlacementArea
-{
-    glm::vec3 position;
-    bool isOccupied = false;
-    float angle; // direction based on 0 being -Z
-    std::array<glm::vec3, 4> zoneVerticesArray; // For collision
-    // 0 - 5 (zero is low, 5 is high)
-    int deepness = 0; // Value that determines how deep the value is relative to the endes of the road (will give larger houses for ones in the center)
-
-    // Checks if two orienteted rectangles collide, using SAT - seperate axis theorem
-    bool Intersects(const std::array<glm::vec3, 4>& boundingBox)
-    {
-        // First we check the axis of our zone
-        std::array<glm::vec3, 8> axis;
-
-        size_t i;
-        // Get all 4 edges of both rectangles
-        for (i = 0; i < 4; i++)
-        {
-            // Get each vector of each edge and then get its perits adjacent one and then put them into a bix array
-            axis[i] = glm::normalize(getPerpendicularXZ(zoneVerticesArray[(i + 1) % 4] - zoneVerticesArray[i]));
-            axis[i+4] = glm::normalize(getPerpendicularXZ(boundingBox[(i + 1) % 4] - boundingBox[i]));
-        }
-
-        for (i = 0; i < 8; i++)
-        {
-            if (!projectionOverlap(zoneVerticesArray, boundingBox, axis[i]))
-            {
-                return false;
-            }
-        }
-
-        // Does not intersect
-        return true;
-    }
-
-    bool TooFarForCollision(const PlacementArea* area_in)
-    {
-        if (glm::length(position-area_in->position) <= buildingCollisionThresholdDetection)
-        {
-            return false;
-        }
-        return true;
-    }
-
-};
+#include <roadGeometry.hpp>
 
 // Forward declaration
 class Shader;
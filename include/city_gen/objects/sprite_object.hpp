@@ -3,6 +3,8 @@
 #include <base_object.hpp>
 #include <camera.hpp>
 #include <bounding_box.hpp>
+#include <transformStore.hpp>
+#include <assetId.hpp>
 
 // Forward declarations
 class SpriteRenderer;
@@ -35,6 +37,8 @@ public:
     void DrawBoundingBox(glm::vec3 colour);
 
     glm::mat4 GetModelMatrix(void);
+    // @brief What the model matrix of a sprite that is not a billboard is built from, kept by the instance renderer
+    InstanceTransform GetInstanceTransform(void) const;
     const SpriteRenderer* GetSpriteRenderer(void) const;
     const BoundingBox* GetBoundingBox(void) const;
 
@@ -46,6 +50,7 @@ public:
     SpriteObject* SetLightingEnabled(bool toggle);
     std::string const& GetSpriteName();
     std::string const& GetSpritePath();
+    AssetId GetSpriteAssetId() const;
     
     glm::vec2 GetScale(void) const
     {
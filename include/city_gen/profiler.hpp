@@ -0,0 +1,135 @@
+#pragma once
+/*
+    Scoped timers for the generation stages.
+
+    PROFILE_SCOPE("name") records a span from where it is declared to the end of its scope with
+    nanosecond timestamps, spans nest. PROFILE_COUNTER("name", value) adds a count to the innermost
+    open span of the calling thread. Every thread records into its own buffer so pool workers never
+    wait on each other, the buffers are only read when the trace is written.
+
+    Nothing is recorded outside a session, a timer then costs a single atomic load. EndSession
+    writes the session as a Chrome trace_event json file, open it in chrome://tracing or Perfetto.
+
+    Span and counter names are kept as pointers, they must be string literals.
+*/
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define LOG_PROFILER "PROFILER"
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+// Time the rest of the enclosing scope
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+// Add a counter to the innermost open span of this thread
+#define PROFILE_COUNTER(name, value) Profiler::AddCounter(name, static_cast<int64_t>(value))
+
+class Profiler
+{
+private:
+    static Profiler* pInstance;
+    Profiler() = default;
+
+    struct Counter
+    {
+        const char* name;
+        int64_t value;
+    };
+
+    struct Span
+    {
+        const char* name;
+        int64_t start;          // ns since the session began
+        int64_t duration;       // ns, -1 while open
+        std::vector<Counter> counters;
+    };
+
+    struct ThreadBuffer
+    {
+        uint32_t threadId;
+        uint32_t session = 0;   // Session the spans belong to, cleared when a new one begins
+        std::mutex mutex;       // Only contended while the trace is written
+        std::vector<Span> spans;
+        std::vector<size_t> openSpans;
+    };
+
+    static std::atomic<bool> recording;
+    static std::atomic<uint32_t> session;
+    static std::atomic<int64_t> sessionStart;
+
+    std::mutex buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    static thread_local ThreadBuffer* threadBuffer;
+
+    // @brief Buffer of the calling thread, made on first use and cleared if it holds an older session
+    static ThreadBuffer* getThreadBuffer(void);
+
+    static int64_t now(void);
+
+    friend class ProfileScope;
+
+public:
+    // Singleton
+    Profiler(Profiler &other) = delete;
+    void operator=(const Profiler &) = delete;
+    static Profiler* getInstance();
+
+    // @brief Start recording, spans of any earlier session are dropped
+    void BeginSession(void);
+
+    // @brief Stop recording, the spans are kept until the next session begins
+    void EndSession(void);
+
+    // @brief Stop recording and write the spans as a Chrome trace
+    // Spans still open are left out
+    // @args path - json file to write
+    // @returns false if the file could not be written
+    bool EndSession(const std::string& path);
+
+    // Time spent under one span name
+    struct SpanTotal
+    {
+        std::string name;
+        uint64_t count;
+        int64_t duration;   // ns, summed over every thread
+    };
+
+    // @brief Totals of each span name over the last session, call after EndSession
+    // @returns totals in the order the names were first seen
+    std::vector<SpanTotal> GetSpanTotals(void);
+
+    // @brief Totals of the spans the calling thread closed since its last take, those spans are dropped.
+    // For threads that each time their own piece of work within one session, call with no span open
+    // @returns totals in the order the names were first seen
+    static std::vector<SpanTotal> TakeThreadSpanTotals(void);
+
+    static bool IsRecording(void) { return recording.load(std::memory_order_relaxed); }
+
+    // @brief Add a counter to the innermost open span of the calling thread, see PROFILE_COUNTER
+    static void AddCounter(const char* name, int64_t value);
+
+private:
+    // @brief Add the closed spans to the totals of their names
+    static void addSpanTotals(const std::vector<Span>& spans, std::vector<SpanTotal>& totals);
+};
+
+
+// Records a span over its lifetime, see PROFILE_SCOPE
+class ProfileScope
+{
+private:
+    Profiler::ThreadBuffer* buffer = nullptr;
+    uint32_t session = 0;
+
+public:
+    explicit ProfileScope(const char* name);
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope&) = delete;
+    void operator=(const ProfileScope&) = delete;
+};
@@ -8,6 +8,7 @@
 #include <string>
 
 #include <mesh.hpp>
+#include <assetId.hpp>
 
 // Forward declarations
 class BoundingBox;
@@ -23,6 +24,7 @@ private:
     BoundingBox* modelBoundingBox;
 
     std::string modelPath;
+    AssetId assetId = 0;    // Interned modelPath, set by the resource manager
 
 
     // model data
@@ -60,6 +62,16 @@ public:
         return modelPath;
     }
 
+    inline AssetId GetAssetId() const
+    {
+        return assetId;
+    }
+
+    inline void SetAssetId(AssetId id)
+    {
+        assetId = id;
+    }
+
     inline std::string GetModelName() const
     {
         std::string name = modelPath.substr(modelPath.find_last_of('/')+1, modelPath.size()-1);
@@ -3,9 +3,11 @@
 #include "indexBuffer.hpp"
 #include "vertexArray.hpp"
 #include "vertexBuffer.hpp"
+#include "transformStore.hpp"
 #include <glm/glm.hpp>
 #include <config.hpp>
 #include <road_object.hpp>
+#include <type_traits>
 
 // Defined outside of Glad as we cant include several times
 #define GL_POINTS 0x0000
@@ -28,30 +30,49 @@ constexpr unsigned int ROAD_MAX_IND_BUFFER_SIZE_BYTES = ROAD_MAX_INDICES * sizeo
 struct InstanceObject
 {
     void* address;
-    unsigned long renderID;
+    unsigned long renderID;     // Slot in the renderer, the same as the object's instance index
 };
 
 template<class T>
 class InstanceRenderer
 {
 private:
+    // Object type behind the T pointers
+    using Object = std::remove_pointer_t<T>;
+
     // Dynamic arrays of the objects and matrices of each object
     std::vector<InstanceObject> objects;
     std::vector<float> matrices;
+    // Transforms of the objects, same order as objects. Their matrices are written from here
+    TransformStore transforms;
+
+    // Instances with no object, e.g. the buildings of a city snapshot. Their matrices come
+    // first in matrices, the matrix of objects[i] is at staticCount + i
+    T staticType = nullptr;
+    size_t staticCount = 0;
+
+    // Slot of an object from the handle it keeps, noInstanceIndex if it is not in this renderer
+    size_t find(T object) const;
 
 public:
     // @brief Add another object
     // @param object pointer to add
     void Append(T object);
 
-    // @brief Remove an object
+    // @brief Remove an object, the last object is moved into its slot
     // @param object pointer to remove
     void Remove(T object);
 
+    // @brief Add a block of instances with no object behind them, copied as is into the matrices
+    // @args type - object drawn for the instances, the caller keeps it alive while the renderer is used
+    // @args instanceMatrices - count column major mat4s
+    // @args count - number of instances
+    void AppendStatic(T type, const float* instanceMatrices, size_t count);
+
     // @brief Remove all objects
     void Clear(void);
 
-    // @brief Update one of the objects
+    // @brief Update one of the objects, its matrix is written before the next draw
     // @brief object pointer to update
     void Update(T object);
 
@@ -62,28 +83,53 @@ public:
     void Draw(void);
 
     // @brief Get the object the instancerenderer is using
-    // @return A pointer to the first object in the instance renderer, if empty then nullptr
+    // @return A pointer to the first object in the instance renderer, the static type if there are
+    // only static instances, if empty then nullptr
     const T GetInstanceType(void) const;
 
     // @brief Get number of objects in renderer
-    // @returns size_t number of objects in instance renderer
+    // @returns size_t number of objects and static instances in instance renderer
     const size_t size(void) const;
+
+    // @brief Matrices of every instance, static ones first, with every update written
+    // @returns 16 floats per instance
+    const std::vector<float>& GetMatrices(void);
 };
 
 // Batch renderer is only setup to draw simple geometry such as roads
+// Each road has a slot of ROAD_MAX_VERTICES vertices and ROAD_MAX_INDICES indices, its renderID.
+// Unused indices of a slot are degenerate triangles, so roads are appended and removed a slot at a time
 class BatchRenderer
 {
 private:
     VertexBuffer* VBO;
     VertexArray* VAO;
     IndexBuffer* EBO;
+
+    // Road in each slot
+    std::vector<RoadObject*> slots;
+    // Slots the buffers have room for
+    size_t capacity = 0;
+
+    // @brief Create the buffers with room for a number of roads, their contents are lost
+    void allocate(size_t roadCount);
+    // @brief Upload the roads of slots [first, last) in one go
+    void writeSlots(size_t first, size_t last);
 public:
     BatchRenderer();
     ~BatchRenderer();
 
-    // @brief Update all roads vertices and indices
+    // @brief Update all roads vertices and indices, the roads get slots in scene order
     void UpdateAll(void);
 
+    // @brief Add roads to the end of the batch, only their slots are uploaded unless the buffers have to grow
+    // @args roads - roads already in the scene and not in the batch
+    void Append(const std::vector<RoadObject*>& roads);
+
+    // @brief Take roads out of the batch, the last roads are moved into their slots
+    // @args roads - roads in the batch, others are ignored
+    void Remove(const std::vector<RoadObject*>& roads);
+
     // @brief Update one road's vertices and indices
     // @args renderID - the renderID owned by the road
     // @args vertices - pointer to a dynamic array of the vertices of the road
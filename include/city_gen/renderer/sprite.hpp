@@ -13,6 +13,7 @@
 #include <vertexArray.hpp>
 #include <vertexBuffer.hpp>
 #include <indexBuffer.hpp>
+#include <assetId.hpp>
 
 // Forward declaration
 class Shader;
@@ -32,6 +33,7 @@ private:
 
     std::string texturePath;
     unsigned int spriteTextureID;
+    AssetId textureAssetId;
 
     // Binding VAO's etc.
     void SetupSprite(float vertices[], unsigned int indices[]);
@@ -56,6 +58,9 @@ public:
     inline std::string GetTexturePath()
         { return texturePath; }
 
+    inline AssetId GetTextureAssetId() const
+        { return textureAssetId; }
+
     inline BoundingBox* GetBoundingBox()
         { return spriteBoundingBox; }
 
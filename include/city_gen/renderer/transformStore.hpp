@@ -0,0 +1,81 @@
+#pragma once
+/*
+    SoA store of the transforms of instance rendered objects.
+
+    ModelObject::GetModelMatrix used to multiply four mat4s and invert the origin translation for
+    every object, every time the instance renderer asked for it. The instance renderer keeps the
+    transform of each instance here instead, 8 instances to a block with one array per component,
+    and marks the instances that changed. ComputeDirty then writes the model matrix of every dirty
+    instance straight into the instance matrix array, 8 at a time with AVX2, 4 with SSE or one at a
+    time with the scalar fallback, over the thread pool when there are enough of them.
+
+    The sine and cosine of the rotation are taken when a transform is set, the kernel itself is only
+    multiplies and adds. The matrix is the one GetModelMatrix gives:
+        translate(position) * rotate(rotation) * scale(scale) * translate(-origin)
+*/
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Everything the model matrix of an object is built from
+struct InstanceTransform
+{
+    glm::vec3 position;
+    glm::vec3 rotation;     // Angles as in BaseObject::getRotateMat4
+    glm::vec3 scale;        // Scalar scale already applied
+    glm::vec3 origin;
+};
+
+// @brief Model matrix of one transform, the scalar version of the batched kernel
+glm::mat4 ComputeModelMatrix(const InstanceTransform& transform);
+
+// Eight transforms in SoA form, [component][lane]
+struct alignas(32) TransformBlock
+{
+    static constexpr int lanes = 8;
+
+    float position[3][lanes];
+    float sinAngle[3][lanes];
+    float cosAngle[3][lanes];
+    float scale[3][lanes];
+    float origin[3][lanes];
+
+    void Set(int lane, const InstanceTransform& transform);
+    void CopyLane(int from, const TransformBlock& source, int to);
+};
+
+// Transforms of the instances of an instance renderer, instance i is lane i%8 of block i/8
+class TransformStore
+{
+public:
+    void Clear(void);
+    size_t Size(void) const { return count; }
+
+    // @brief Add an instance at the end, it is dirty until the next ComputeDirty
+    void Add(const InstanceTransform& transform);
+
+    // @brief Replace the transform of an instance and mark it dirty
+    void Set(size_t index, const InstanceTransform& transform);
+
+    // @brief Remove an instance, the last one moves into its index with its dirty mark
+    void SwapRemove(size_t index);
+
+    // @brief Write the model matrix of every dirty instance and clear the marks
+    // @args matrices - 16 floats (column major mat4) per instance, instance i is at matrices + 16*i
+    void ComputeDirty(float* matrices);
+
+    // @brief Replace every transform and write every matrix, split over the thread pool for large stores
+    // @args transform - gives the transform of an instance, called from several threads at once
+    // @args matrices - as ComputeDirty
+    void SetAll(const std::function<InstanceTransform(size_t)>& transform, float* matrices);
+
+private:
+    std::vector<TransformBlock> blocks;
+    std::vector<uint8_t> dirtyLanes;    // Bit l of block b is set if lane l changed
+    size_t count = 0;
+    bool anyDirty = false;
+
+    void computeBlocks(size_t firstBlock, size_t endBlock, bool dirtyOnly, float* matrices);
+};
@@ -17,6 +17,7 @@
 #include <stb_image/stb_image.h>        // image reading
 
 #include <config.hpp>                   // logging
+#include <assetId.hpp>
 #include <shader.hpp>
 #include <model.hpp>
 
@@ -29,6 +30,7 @@ struct TextureInfo{
     int width;              // width of texture
     int height;             // height of texture
     std::string fileName;   // Name of texture
+    AssetId assetId;        // Interned fileName
 };
 
 
@@ -46,6 +48,9 @@ private:
     // Search with model path e.g. box.obj. Return model underlying loaded model
     std::unordered_map<std::string, Model*> model_map;
 
+    // Interned asset paths, ids are given in the order paths are first seen
+    std::unordered_map<std::string, AssetId> asset_ids;
+
     static ResourceManager* pinstance;
     ResourceManager() {};
     ~ResourceManager(); 
@@ -73,6 +78,11 @@ public:
     // Load model
     Model* LoadModel(const std::string& modelPath_in, Shader* modelShader_in);
 
+    // @brief Get the id of an asset path, a path seen for the first time gets the next id
+    // @args path - model or texture path as passed to LoadModel or LoadTexture
+    // @returns the id models and textures loaded from the path have
+    AssetId InternAssetPath(const std::string& path);
+
     // @brief Load the model shader and return the shader resource
     // @args shader_in - A pointer to the ShaderPath struct, can be nullptr to load default
     // @args instanced - boolean to load the default instanced shader when shader_in is nullptr
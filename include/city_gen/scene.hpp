@@ -14,8 +14,10 @@
 #include <objects/all.hpp>
 #include <skybox.hpp>
 #include <shader.hpp>
+#include <objectPool.hpp>
 
 #include <vector>
+#include <unordered_map>
 
 // SceneObject types
 typedef enum class e_SceneType
@@ -93,6 +95,7 @@ class Scene
 private:
     // Scene objects specific to objects
     // This allows us to choose rendering order with minimal overhead
+    // Models, sprites and roads live in the pools below, the lists only point into them
     std::vector<ModelObject*> scene_model_objects;
     std::vector<SpriteObject*> scene_sprite_objects;
     std::vector<LineObject*> scene_line_objects;
@@ -129,16 +132,31 @@ private:
     int dirLightCount = 0;
     int pointLightCount = 0;
 
-    // Instance renderers
+    // Instance renderers, in the order they are drawn
     std::vector<InstanceRenderer<ModelObject*>*> modelInstanceRenderers;
     std::vector<InstanceRenderer<SpriteObject*>*> spriteInstanceRenderers;
+    // The same renderers by the asset id of the model or texture they draw
+    std::unordered_map<AssetId, InstanceRenderer<ModelObject*>*> modelInstanceRendererIds;
+    std::unordered_map<AssetId, InstanceRenderer<SpriteObject*>*> spriteInstanceRendererIds;
+    // Models drawn for instances with no object of their own (addModelInstances), not in scene_model_objects
+    std::unordered_map<AssetId, ModelObject*> instanceTypeObjects;
+
+    // Storage of the objects a city is made of, emptied as a whole by the removeAll methods
+    ObjectPool<ModelObject> modelPool;
+    ObjectPool<SpriteObject> spritePool;
+    ObjectPool<RoadObject> roadPool;
  
 
     // Methods to add objects to instance renderers
-    void addModelToInstanceRenderer(ModelObject* modelObject_in,
-                                    const std::string& modelPath_in);
-    void addSpriteToInstanceRenderer(SpriteObject* spriteObject_in,
-                                     const std::string& spritePath_in);
+    void addModelToInstanceRenderer(ModelObject* modelObject_in);
+    void addSpriteToInstanceRenderer(SpriteObject* spriteObject_in);
+
+    // Methods to take objects out of their instance renderers, an emptied renderer is deleted
+    void removeModelFromInstanceRenderer(ModelObject* modelObject_in);
+    void removeSpriteFromInstanceRenderer(SpriteObject* spriteObject_in);
+
+    // @brief Instance renderer of an asset, created empty if there is none
+    InstanceRenderer<ModelObject*>* getOrAddModelInstanceRenderer(AssetId model);
 
     template<class T, class U>
     static bool SortByDistanceInv(BaseObject<T>* a, BaseObject<U>* b);
@@ -169,6 +187,16 @@ public:
                           const ShaderPath* shader_in = nullptr,
                           const bool instanced = false);
 
+    // @brief Add instances of a model without an object for each, they are drawn but cannot be selected or moved
+    // @args modelPath_in - model to draw, shares the instance renderer of objects with the same model
+    // @args shader_in - instanced shader to draw the model with
+    // @args matrices - count column major mat4s, copied into the instance renderer as one block
+    // @args count - number of instances
+    void addModelInstances(const std::string& modelPath_in,
+                           const ShaderPath* shader_in,
+                           const float* matrices,
+                           size_t count);
+
     // 2D sprites
     SpriteObject* addSprite(const std::string& spriteTexture_in,
                             const ShaderPath* shader_in = nullptr,
@@ -218,6 +246,18 @@ public:
     void removeDirectionalLight(DirectionalLightObject& obj);
     void removeRoad(const RoadObject& obj);
 
+    // Remove individual objects and destroy them, the objects must not be used after.
+    // An object only removed is destroyed by the removeAll method of its type
+    void destroyModel(ModelObject* obj);
+    void destroySprite(SpriteObject* obj);
+    void destroyRoad(RoadObject* obj);
+
+    // Destroy many objects with one pass over the scene, for objects that leave together such as a chunk's.
+    // Roads are not taken out of the road batch renderer
+    void destroyModels(const std::vector<ModelObject*>& objs);
+    void destroySprites(const std::vector<SpriteObject*>& objs);
+    void destroyRoads(const std::vector<RoadObject*>& objs);
+
     // Clear types of objects (delete them all)
     void removeAllModels(void);
     void removeAllSprites(void);
@@ -0,0 +1,64 @@
+#pragma once
+/*
+    Worker threads for the generator.
+
+    Work is handed out with ParallelFor, the calling thread takes part and the call
+    blocks until every index is done. A ParallelFor from inside a worker runs on the
+    calling thread so nested stages cannot deadlock the pool.
+
+    Anything run through the pool must not draw from the global Random state, use a
+    RandomStream per task so results do not depend on the thread count.
+*/
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define LOG_POOL "THREADPOOL"
+
+class ThreadPool
+{
+private:
+    static ThreadPool* pInstance;
+    ThreadPool();
+    ~ThreadPool();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex taskMutex;
+    std::condition_variable taskAvailable;
+    bool stopping = false;
+
+    void startWorkers(size_t workerCount);
+    void stopWorkers(void);
+    void workerLoop(void);
+
+public:
+    // Singleton
+    ThreadPool(ThreadPool &other) = delete;
+    void operator=(const ThreadPool &) = delete;
+    static ThreadPool* getInstance();
+
+    // @brief Number of threads work is split over, including the calling thread
+    size_t GetThreadCount(void) const { return workers.size() + 1; }
+
+    // @brief Restart the pool with a new number of threads, 0 uses the hardware concurrency
+    // Must not be called while a ParallelFor is running
+    // @args threadCount - threads including the calling thread, 1 runs everything on the caller
+    void SetThreadCount(size_t threadCount);
+
+    // @brief Run body(i) for every i in [0, count), blocks until all are done
+    // Indices are handed out one at a time so uneven work (cities of different sizes) balances out.
+    // The first exception thrown by body is rethrown on the calling thread
+    // @args count - number of indices
+    // @args body - work for one index, called concurrently from several threads
+    void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    // @brief Queue a task to run on a pool thread without waiting for it, runs inline when there are no workers
+    // The task has to hand its results back itself. Exceptions thrown by the task are logged and dropped
+    // @args task - work to run, may call ParallelFor which will run inline
+    void Submit(std::function<void()> task);
+};
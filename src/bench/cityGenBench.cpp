@@ -0,0 +1,339 @@
+// Generation benchmarks
+//
+// Runs the generator headless over a fixed corpus of seeds, forced city counts and grammar depths.
+// Each case is written as one json line with its wall time, the time of every generation stage
+// (from the profiler), peak RSS, object counts and a hash of the generated city. Comparing the
+// hashes against a baseline run catches an optimisation that changes the output.
+//
+// Usage: city-gen-bench [--repeat N] [--threads N] [--out path] [--baseline path] [--filter text]
+
+#include <generator.hpp>
+#include <config.hpp>
+#include <threadPool.hpp>
+#include <profiler.hpp>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define LOG_BENCH "BENCH"
+
+struct BenchCase
+{
+    std::string name;
+    unsigned int seed;
+    CityGenerationOverrides overrides;
+    bool isChunk = false;
+    ChunkCoord chunk = {0, 0};
+    CrossingPolicy crossings = CrossingPolicy::REMOVE;
+};
+
+struct BenchResult
+{
+    std::vector<int64_t> times;     // ns of each repeat
+    std::vector<Profiler::SpanTotal> stages; // of the fastest repeat
+    int64_t peakRssKb = 0;
+    size_t roads = 0, buildings = 0, trees = 0;
+    uint64_t hash = 0;
+    bool deterministic = true;
+};
+
+// The corpus is fixed so results can be compared between builds, add cases at the end
+std::vector<BenchCase> makeCorpus(void)
+{
+    std::vector<BenchCase> corpus;
+
+    // Cities as the seed makes them
+    for (unsigned int seed : {1u, 7u, 42u, 1234u, 31337u, 2024u})
+    {
+        corpus.push_back({"seed_" + std::to_string(seed), seed, {}});
+    }
+
+    // Forced city counts and grammar depths, the depth is what makes a city slow
+    for (int cities : {1, 3, 6})
+    {
+        for (int iterations = 2; iterations <= 6; iterations++)
+        {
+            corpus.push_back({"cities_" + std::to_string(cities) + "_iterations_" + std::to_string(iterations), 42, {cities, iterations}});
+        }
+    }
+
+    // Chunks of a tiled world
+    for (ChunkCoord chunk : {ChunkCoord{1, 1}, ChunkCoord{-1, 0}})
+    {
+        corpus.push_back({"chunk_7_" + std::to_string(chunk.x) + "_" + std::to_string(chunk.z), 7, {}, true, chunk});
+    }
+
+    // Crossing roads split into junctions instead of removed
+    for (unsigned int seed : {7u, 42u, 1234u})
+    {
+        corpus.push_back({"split_seed_" + std::to_string(seed), seed, {}, false, {0, 0}, CrossingPolicy::SPLIT});
+    }
+
+    return corpus;
+}
+
+
+// FNV-1a over the json of the city, any change to a road, zone, building or tree changes it
+uint64_t hashCity(const CityData& city)
+{
+    std::ostringstream json;
+    WriteCityJson(city, json);
+
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : json.str())
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+
+// Linux only: writing 5 to clear_refs resets the peak RSS of the process so each case gets its own
+void resetPeakRss(void)
+{
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (clearRefs.is_open()) { clearRefs << "5"; }
+}
+
+
+// Peak RSS in kB since the last reset, the peak of the whole process if it could not be reset
+int64_t getPeakRssKb(void)
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.rfind("VmHWM:", 0) == 0)
+        {
+            return std::stoll(line.substr(6));
+        }
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+
+BenchResult runCase(const BenchCase& benchCase, int repeat)
+{
+    BenchResult result;
+    resetPeakRss();
+    generator::SetCrossingPolicy(benchCase.crossings);
+
+    int64_t fastest = INT64_MAX;
+    for (int r = 0; r < repeat; r++)
+    {
+        Profiler::getInstance()->BeginSession();
+        auto startTime = std::chrono::steady_clock::now();
+
+        CityData city = benchCase.isChunk ? generator::GenerateChunkData(benchCase.seed, benchCase.chunk)
+                                          : generator::GenerateCityData(benchCase.seed, benchCase.overrides);
+
+        const int64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+        Profiler::getInstance()->EndSession();
+        result.times.push_back(time);
+
+        if (time < fastest)
+        {
+            fastest = time;
+            result.stages = Profiler::getInstance()->GetSpanTotals();
+        }
+
+        const uint64_t hash = hashCity(city);
+        if (r > 0 && hash != result.hash) { result.deterministic = false; }
+        result.hash = hash;
+        result.roads = city.roads.size();
+        result.buildings = city.buildings.size();
+        result.trees = city.trees.size();
+    }
+
+    result.peakRssKb = getPeakRssKb();
+    return result;
+}
+
+
+std::string toHex(uint64_t value)
+{
+    std::ostringstream hex;
+    hex << std::hex;
+    hex.width(16);
+    hex.fill('0');
+    hex << value;
+    return hex.str();
+}
+
+
+double toMilliseconds(int64_t nanoseconds)
+{
+    return static_cast<double>(nanoseconds) / 1e6;
+}
+
+
+// One case per line so results can be diffed and read back by readBaseline
+void writeResult(std::ostream& out, const BenchCase& benchCase, const BenchResult& result)
+{
+    std::vector<int64_t> sorted = result.times;
+    std::sort(sorted.begin(), sorted.end());
+
+    out << "{\"case\":\"" << benchCase.name << "\",\"seed\":" << benchCase.seed
+        << ",\"cities\":" << benchCase.overrides.numberOfCities << ",\"iterations\":" << benchCase.overrides.iterations
+        << ",\"min_ms\":" << toMilliseconds(sorted.front()) << ",\"median_ms\":" << toMilliseconds(sorted[sorted.size()/2])
+        << ",\"stages_ms\":{";
+    for (size_t i = 0; i < result.stages.size(); i++)
+    {
+        out << (i == 0 ? "" : ",") << "\"" << result.stages[i].name << "\":" << toMilliseconds(result.stages[i].duration);
+    }
+    out << "},\"peak_rss_kb\":" << result.peakRssKb
+        << ",\"roads\":" << result.roads << ",\"buildings\":" << result.buildings << ",\"trees\":" << result.trees
+        << ",\"hash\":\"" << toHex(result.hash) << "\"}";
+}
+
+
+// Case name to hash from a file written by an earlier run
+std::map<std::string, std::string> readBaseline(const std::string& path)
+{
+    std::map<std::string, std::string> hashes;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        const size_t casePos = line.find("\"case\":\"");
+        const size_t hashPos = line.find("\"hash\":\"");
+        if (casePos == std::string::npos || hashPos == std::string::npos)
+            continue;
+
+        const size_t caseStart = casePos + 8, hashStart = hashPos + 8;
+        hashes[line.substr(caseStart, line.find('"', caseStart) - caseStart)] = line.substr(hashStart, line.find('"', hashStart) - hashStart);
+    }
+    return hashes;
+}
+
+
+void printUsage(const char* name)
+{
+    std::cout << "Usage: " << name << " [--repeat N] [--threads N] [--out path] [--baseline path] [--filter text]" << std::endl;
+    std::cout << "  --repeat N       runs of each case, the fastest and median are reported (default 3)" << std::endl;
+    std::cout << "  --threads N      threads to generate with, 0 for one per core (default 0)" << std::endl;
+    std::cout << "  --out path       json file to write (default bench.json)" << std::endl;
+    std::cout << "  --baseline path  results of an earlier run, fails if a city hash changed" << std::endl;
+    std::cout << "  --filter text    only run cases with text in their name" << std::endl;
+}
+
+
+// Swallows the generator logs while a case runs, printing them would be timed too
+class NullBuffer : public std::streambuf
+{
+protected:
+    int overflow(int c) override { return c; }
+};
+
+
+int main(int argc, char** argv)
+{
+    int repeat = 3;
+    size_t threadCount = 0;
+    std::string outPath = "bench.json";
+    std::string baselinePath;
+    std::string filter;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--repeat") == 0 && i+1 < argc)
+        {
+            repeat = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && i+1 < argc)
+        {
+            threadCount = std::stoul(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--out") == 0 && i+1 < argc)
+        {
+            outPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--baseline") == 0 && i+1 < argc)
+        {
+            baselinePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0 && i+1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (threadCount != 0)
+    {
+        ThreadPool::getInstance()->SetThreadCount(threadCount);
+    }
+
+    std::map<std::string, std::string> baseline;
+    if (!baselinePath.empty())
+    {
+        baseline = readBaseline(baselinePath);
+        if (baseline.empty())
+        {
+            LOG(ERROR_SERV(LOG_BENCH), "No results in baseline file: " << baselinePath);
+            return 1;
+        }
+    }
+
+    std::ofstream outFile(outPath);
+    if (!outFile.is_open())
+    {
+        LOG(ERROR_SERV(LOG_BENCH), "Failed to open output file: " << outPath);
+        return 1;
+    }
+
+    NullBuffer nullBuffer;
+    int failures = 0;
+    bool first = true;
+    outFile << "[\n";
+    for (const BenchCase& benchCase : makeCorpus())
+    {
+        if (!filter.empty() && benchCase.name.find(filter) == std::string::npos)
+            continue;
+
+        std::streambuf* coutBuffer = std::cout.rdbuf(&nullBuffer);
+        BenchResult result = runCase(benchCase, repeat);
+        std::cout.rdbuf(coutBuffer);
+
+        outFile << (first ? "" : ",\n");
+        writeResult(outFile, benchCase, result);
+        first = false;
+
+        std::sort(result.times.begin(), result.times.end());
+        LOG(STATUS_SERV(LOG_BENCH), benchCase.name << ": " << toMilliseconds(result.times.front()) << "ms, "
+            << result.roads << " roads, " << result.buildings << " buildings, " << result.trees << " trees, "
+            << result.peakRssKb << "kB peak, hash " << toHex(result.hash));
+
+        if (!result.deterministic)
+        {
+            LOG(ERROR_SERV(LOG_BENCH), benchCase.name << " generated different cities on repeated runs");
+            failures++;
+        }
+        auto baselineHash = baseline.find(benchCase.name);
+        if (baselineHash != baseline.end() && baselineHash->second != toHex(result.hash))
+        {
+            LOG(ERROR_SERV(LOG_BENCH), benchCase.name << " hash " << toHex(result.hash) << " differs from the baseline " << baselineHash->second);
+            failures++;
+        }
+    }
+    outFile << "\n]\n";
+
+    LOG(STATUS_SERV(LOG_BENCH), "Results written to " << outPath);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+#include <chunkStreamer.hpp>
+
+#include <config.hpp>
+#include <scene.hpp>
+#include <threadPool.hpp>
+#include <cityRandom.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#define LOG_STREAM "CHUNKSTREAM"
+
+ChunkStreamer* ChunkStreamer::pInstance{nullptr};
+
+ChunkStreamer* ChunkStreamer::getInstance()
+{
+    if (pInstance == nullptr)
+    {
+        pInstance = new ChunkStreamer();
+    }
+    return pInstance;
+}
+
+
+unsigned int ChunkStreamer::Start(unsigned int seed_in)
+{
+    Stop();
+    seed = (seed_in == 0) ? Random::GenerateSeed() : seed_in;
+    active = true;
+    LOG(STATUS_SERV(LOG_STREAM), "Streaming world " << seed);
+    return seed;
+}
+
+
+void ChunkStreamer::Stop(void)
+{
+    releaseAllChunks();
+    pendingChunks.clear();
+    generation++;
+    active = false;
+}
+
+
+float ChunkStreamer::getChunkDistance(ChunkCoord chunk, const glm::vec3& position)
+{
+    const glm::vec2 point = {position.x, position.z};
+    const glm::vec2 closest = glm::clamp(point, GetChunkMin(chunk), GetChunkMax(chunk));
+    return glm::length(point - closest);
+}
+
+
+void ChunkStreamer::releaseChunk(CitySceneObjects& objects)
+{
+    Scene* scene = Scene::getInstance();
+
+    // The objects are deleted, make sure none of them stays selected
+    if (scene->sceneSelectedObject->HasObjectSelected())
+    {
+        void* selected = scene->sceneSelectedObject->GetObject();
+        if (std::find(objects.roads.begin(), objects.roads.end(), selected) != objects.roads.end() ||
+            std::find(objects.buildings.begin(), objects.buildings.end(), selected) != objects.buildings.end() ||
+            std::find(objects.trees.begin(), objects.trees.end(), selected) != objects.trees.end())
+        {
+            scene->sceneSelectedObject->Deselect();
+        }
+    }
+
+    // The last roads and instances are swapped into the freed slots, the other chunks are not uploaded again
+    scene->roadBatchRenderer->Remove(objects.roads);
+    scene->destroyRoads(objects.roads);
+    scene->destroyModels(objects.buildings);
+    scene->destroySprites(objects.trees);
+    objects = CitySceneObjects();
+}
+
+
+void ChunkStreamer::releaseAllChunks(void)
+{
+    if (loadedChunks.empty())
+        return;
+
+    for (auto& loaded : loadedChunks)
+    {
+        releaseChunk(loaded.second);
+    }
+    loadedChunks.clear();
+}
+
+
+void ChunkStreamer::Update(const glm::vec3& cameraPosition)
+{
+    if (!active)
+        return;
+
+    // Unload chunks that are now too far away, half a chunk past the load radius so a camera on the edge does not thrash
+    const float unloadRadius = loadRadius + chunkSize/2;
+    for (auto it = loadedChunks.begin(); it != loadedChunks.end();)
+    {
+        if (getChunkDistance(it->first, cameraPosition) > unloadRadius)
+        {
+            releaseChunk(it->second);
+            it = loadedChunks.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // Queue the chunks in range that are not loaded yet, closest first
+    const ChunkCoord center = GetChunkCoord(cameraPosition);
+    const int reach = static_cast<int>(std::ceil(loadRadius / chunkSize));
+    std::vector<std::pair<float, ChunkCoord>> wanted;
+    for (int dx = -reach; dx <= reach; dx++)
+    {
+        for (int dz = -reach; dz <= reach; dz++)
+        {
+            const ChunkCoord chunk = {center.x + dx, center.z + dz};
+            const float distance = getChunkDistance(chunk, cameraPosition);
+            if (distance <= loadRadius && loadedChunks.count(chunk) == 0 && pendingChunks.count(chunk) == 0)
+            {
+                wanted.push_back({distance, chunk});
+            }
+        }
+    }
+    std::sort(wanted.begin(), wanted.end(), [](const auto& a, const auto& b)
+    {
+        return a.first < b.first || (a.first == b.first && (a.second.x < b.second.x || (a.second.x == b.second.x && a.second.z < b.second.z)));
+    });
+
+    for (auto& [distance, chunk] : wanted)
+    {
+        pendingChunks.insert(chunk);
+        ThreadPool::getInstance()->Submit([this, chunk = chunk, chunkGeneration = generation, worldSeed = seed]()
+        {
+            CityData city = generator::GenerateChunkData(worldSeed, chunk);
+            std::lock_guard<std::mutex> lock(finishedMutex);
+            finishedChunks.push_back({chunkGeneration, chunk, std::move(city)});
+        });
+    }
+
+    // Add at most one finished chunk to the scene each frame so frame time stays flat
+    std::vector<FinishedChunk> ready;
+    {
+        std::lock_guard<std::mutex> lock(finishedMutex);
+        ready.swap(finishedChunks);
+    }
+    bool populated = false;
+    for (auto& finished : ready)
+    {
+        // From a world that is no longer streamed
+        if (finished.generation != generation)
+            continue;
+
+        if (populated)
+        {
+            // Keep it for a later frame
+            std::lock_guard<std::mutex> lock(finishedMutex);
+            finishedChunks.push_back(std::move(finished));
+            continue;
+        }
+
+        pendingChunks.erase(finished.chunk);
+        // The camera moved on while it was generating
+        if (getChunkDistance(finished.chunk, cameraPosition) > unloadRadius)
+            continue;
+
+        generator::PopulateScene(finished.city, &loadedChunks[finished.chunk]);
+        populated = true;
+    }
+}
@@ -1,22 +1,161 @@
 #include <cityRandom.hpp>
-#include <cstdlib>
 
-int Random::GetIntBetweenInclusive(int a, int b)
+#include <chrono>
+#include <climits>
+#include <random>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+int Random::GenerateSeed(void)
+{
+    // Seed once per thread rather than building a random_device for every seed
+    static thread_local std::mt19937 gen(std::random_device{}() ^
+        static_cast<uint32_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    std::uniform_int_distribution<int> distribution(1, INT32_MAX);
+    return distribution(gen);
+}
+
+uint64_t Random::MakeKey(uint32_t seed, uint32_t stream)
 {
-    return a + (std::rand() % (b-a));
+    // splitmix64 finalizer so neighbouring seeds and streams give unrelated keys
+    uint64_t z = (static_cast<uint64_t>(seed) << 32 | stream) + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z = z ^ (z >> 31);
+    // Squares wants an odd key
+    return z | 1;
 }
 
-float Random::GetFloatBetweenInclusive(float a, float b)
+uint32_t Random::MakeChunkSeed(uint32_t seed, int32_t chunkX, int32_t chunkZ)
+{
+    // Chain the two coordinates through the key mix, x and z are not interchangeable
+    const uint64_t keyX = MakeKey(seed, static_cast<uint32_t>(chunkX));
+    const uint64_t keyZ = MakeKey(static_cast<uint32_t>(keyX >> 32) ^ static_cast<uint32_t>(keyX), static_cast<uint32_t>(chunkZ));
+    const uint32_t chunkSeed = static_cast<uint32_t>(keyZ >> 32);
+    return (chunkSeed == 0) ? 1 : chunkSeed;
+}
+
+
+RandomStream::RandomStream(uint32_t seed, uint32_t stream, uint64_t index)
+    : key(Random::MakeKey(seed, stream)), index(index)
+{
+}
+
+int RandomStream::GetIntBetweenInclusive(int a, int b)
+{
+    if (a > b) { int temp = a; a = b; b = temp; }
+
+    // Whole 32 bit range, every value is valid
+    const uint32_t range = static_cast<uint32_t>(static_cast<int64_t>(b) - a) + 1;
+    if (range == 0)
+    {
+        return static_cast<int>(GetUInt());
+    }
+
+    // Lemire's multiply and reject, no modulo bias and rarely more than one draw
+    uint64_t product = static_cast<uint64_t>(GetUInt()) * range;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < range)
+    {
+        const uint32_t threshold = -range % range;
+        while (low < threshold)
+        {
+            product = static_cast<uint64_t>(GetUInt()) * range;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return static_cast<int>(a + static_cast<int64_t>(product >> 32));
+}
+
+float RandomStream::GetFloatBetweenInclusive(float a, float b)
 {
     float low, high;
     if (a < b) { low = a; high = b; }
     else { low = b; high = a; }
 
-    return low + static_cast<float>(rand()) /(static_cast<float>(RAND_MAX/(high-low)));
+    return low + GetPercentage() * (high-low);
 }
 
-float Random::GetPercentage(void)
+#if defined(__AVX2__)
+
+// Squares32 on 4 lanes of 64 bits. AVX2 has no 64 bit multiply, it is built from 32x32 -> 64 multiplies.
+// SSE2 has them too but 2 lanes do not make up for the extra multiplies, the scalar loop is faster there
+typedef __m256i Lanes64;
+constexpr int randomLaneWidth = 4;
+inline Lanes64 set1(uint64_t value) { return _mm256_set1_epi64x(static_cast<long long>(value)); }
+inline Lanes64 add64(Lanes64 a, Lanes64 b) { return _mm256_add_epi64(a, b); }
+inline Lanes64 mulLow32(Lanes64 a, Lanes64 b) { return _mm256_mul_epu32(a, b); }
+inline Lanes64 shiftRight64(Lanes64 a, int bits) { return _mm256_srli_epi64(a, bits); }
+inline Lanes64 shiftLeft64(Lanes64 a, int bits) { return _mm256_slli_epi64(a, bits); }
+inline Lanes64 swapHalves(Lanes64 a) { return _mm256_shuffle_epi32(a, _MM_SHUFFLE(2, 3, 0, 1)); }
+
+// Low 32 bits of each lane as percentages
+inline void storePercentages(float* out, Lanes64 bits)
 {
-    return static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+    const __m128i low = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(bits, _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0)));
+    _mm_storeu_ps(out, _mm_mul_ps(_mm_cvtepi32_ps(low), _mm_set1_ps(1.0f / 16777215.0f)));
 }
 
+// a * b mod 2^64, the high halves multiplied together only reach past bit 64
+inline Lanes64 mul64(Lanes64 a, Lanes64 b)
+{
+    const Lanes64 cross = add64(mulLow32(a, shiftRight64(b, 32)), mulLow32(shiftRight64(a, 32), b));
+    return add64(mulLow32(a, b), shiftLeft64(cross, 32));
+}
+
+// x * x mod 2^64 of x = swapHalves(w), both cross terms are the same and the low half of w is the high half of x
+inline Lanes64 squareSwapped64(Lanes64 w)
+{
+    const Lanes64 x = swapHalves(w);
+    return add64(mulLow32(x, x), shiftLeft64(mulLow32(x, w), 33));
+}
+
+#endif
+
+void RandomStream::FillPercentages(float* out, size_t count)
+{
+    const uint64_t start = index;
+    const uint64_t streamKey = key;
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    // Same steps as Random::Squares32 and ToPercentage, a lane per index
+    const Lanes64 laneKey = set1(streamKey);
+    const Lanes64 step = set1(randomLaneWidth);
+    Lanes64 laneIndex = add64(set1(start), _mm256_setr_epi64x(0, 1, 2, 3));
+    for (; i + randomLaneWidth <= count; i += randomLaneWidth)
+    {
+        const Lanes64 y = mul64(laneIndex, laneKey);
+        const Lanes64 z = add64(y, laneKey);
+        // Each round's rotate is folded into the square of the next
+        Lanes64 x = add64(squareSwapped64(swapHalves(y)), y);
+        x = add64(squareSwapped64(x), z);
+        x = add64(squareSwapped64(x), y);
+        // The top 32 bits are the draw, ToPercentage keeps its top 24
+        storePercentages(out + i, shiftRight64(add64(squareSwapped64(x), z), 40));
+        laneIndex = add64(laneIndex, step);
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        out[i] = Random::ToPercentage(Random::Squares32(start + i, streamKey));
+    }
+    index += count;
+}
+
+void RandomStream::FillFloatsBetweenInclusive(float* out, size_t count, float a, float b)
+{
+    float low, high;
+    if (a < b) { low = a; high = b; }
+    else { low = b; high = a; }
+
+    FillPercentages(out, count);
+    const float range = high - low;
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = low + out[i] * range;
+    }
+}
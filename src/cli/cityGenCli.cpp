@@ -0,0 +1,338 @@
+// Headless city generator
+//
+// Generates a city without GLFW or an OpenGL context and writes it out as json
+//
+// Usage: city-gen-cli [--seed N] [--out path] [--threads N] [--grammar path] [--chunk X Z] [--trace path] [--split-crossings]
+//                     [--cache] [--farm FIRST LAST]
+//        seed 0 (default) generates a new city
+//
+// --farm generates every seed of a range on all cores and writes a line of metrics per seed instead of the
+// cities, to pick showcase seeds from. Each city is dropped once it is scored.
+
+#include <generator.hpp>
+#include <cityCache.hpp>
+#include <config.hpp>
+#include <threadPool.hpp>
+#include <profiler.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define LOG_CLI "CLI"
+
+void printUsage(const char* name)
+{
+    std::cout << "Usage: " << name << " [--seed N] [--out path] [--threads N] [--grammar path] [--chunk X Z] [--trace path] [--split-crossings] [--cache] [--farm FIRST LAST]" << std::endl;
+    std::cout << "  --seed N    seed of the city to generate, 0 for a new city (default 0)" << std::endl;
+    std::cout << "  --out path  json file to write, default city_<seed>.json" << std::endl;
+    std::cout << "  --threads N threads to generate with, 0 for one per core (default 0)" << std::endl;
+    std::cout << "  --grammar path  add a grammar file for the cities to pick from, can be given more than once" << std::endl;
+    std::cout << "  --chunk X Z only generate chunk (X, Z) of the tiled world of the seed" << std::endl;
+    std::cout << "  --trace path  write a Chrome trace of the generation stages" << std::endl;
+    std::cout << "  --split-crossings  split crossing roads into junctions instead of removing one, changes the city of the seed" << std::endl;
+    std::cout << "  --cache     read the city from the city cache if the seed was generated before, cache it if not" << std::endl;
+    std::cout << "  --farm FIRST LAST  score every seed from FIRST to LAST instead, --out is csv or .json (default farm_<FIRST>_<LAST>.csv)" << std::endl;
+}
+
+
+// Metrics of one seed of the farm
+struct FarmResult
+{
+    unsigned int seed;
+    size_t roads, buildings, trees, highways;
+    float boundsArea;       // xz area of the box around every road
+    int64_t time;           // ns
+    std::vector<Profiler::SpanTotal> stages;
+};
+
+// Stages written as csv columns, a seed without one of them has 0. The json has every stage
+const char* const farmStageColumns[] = {"GenerateRoads", "cullIntersectingRoads", "splitCrossingRoads", "createHighways",
+    "createNewRoads", "removeDupes", "CreateCityRoads", "BuildRoadGraph", "GenerateTrees", "CalculateValidZones", "GenerateBuildings"};
+
+
+FarmResult scoreCity(const CityData& city)
+{
+    FarmResult result = {city.seed, city.roads.size(), city.buildings.size(), city.trees.size(), 0, 0.0f, 0, {}};
+    if (city.roads.empty())
+        return result;
+
+    glm::vec2 min = {city.roads[0].a.x, city.roads[0].a.z}, max = min;
+    for (const CityRoad& road : city.roads)
+    {
+        // Highways are the only roads without building zones
+        if (!road.allowBuildingZones) { result.highways++; }
+        min = glm::min(min, glm::min(glm::vec2{road.a.x, road.a.z}, glm::vec2{road.b.x, road.b.z}));
+        max = glm::max(max, glm::max(glm::vec2{road.a.x, road.a.z}, glm::vec2{road.b.x, road.b.z}));
+    }
+    result.boundsArea = (max.x - min.x) * (max.y - min.y);
+    return result;
+}
+
+
+void writeFarmHeader(std::ostream& out, bool json)
+{
+    if (json)
+    {
+        out << "[\n";
+        return;
+    }
+    out << "seed,roads,buildings,trees,highways,bounds_area,time_ms";
+    for (const char* stage : farmStageColumns)
+    {
+        out << "," << stage << "_ms";
+    }
+    out << "\n";
+}
+
+
+void writeFarmResult(std::ostream& out, bool json, bool first, const FarmResult& result)
+{
+    if (json)
+    {
+        out << (first ? "" : ",\n") << "{\"seed\":" << result.seed << ",\"roads\":" << result.roads << ",\"buildings\":" << result.buildings
+            << ",\"trees\":" << result.trees << ",\"highways\":" << result.highways << ",\"bounds_area\":" << result.boundsArea
+            << ",\"time_ms\":" << result.time / 1e6 << ",\"stages_ms\":{";
+        for (size_t i = 0; i < result.stages.size(); i++)
+        {
+            out << (i == 0 ? "" : ",") << "\"" << result.stages[i].name << "\":" << result.stages[i].duration / 1e6;
+        }
+        out << "}}";
+        return;
+    }
+
+    out << result.seed << "," << result.roads << "," << result.buildings << "," << result.trees << "," << result.highways
+        << "," << result.boundsArea << "," << result.time / 1e6;
+    for (const char* stage : farmStageColumns)
+    {
+        auto it = std::find_if(result.stages.begin(), result.stages.end(), [&](const Profiler::SpanTotal& total) { return total.name == stage; });
+        out << "," << (it == result.stages.end() ? 0.0 : it->duration / 1e6);
+    }
+    out << "\n";
+}
+
+
+// Swallows the generator logs of the farm, thousands of cities would bury the progress
+class NullBuffer : public std::streambuf
+{
+protected:
+    int overflow(int c) override { return c; }
+};
+
+
+// @brief Generate and score every seed in [first, last], results are written as they finish so not in seed order
+// Each seed is a task on its own pool thread, the stages of a seed then run inline on that thread so its
+// profiler spans are its stage times. Only one seed per pool thread is handed out at a time so at most
+// that many cities are alive
+// @returns the process exit code
+int runSeedFarm(unsigned int first, unsigned int last, const std::string& outPath)
+{
+    const bool json = outPath.size() >= 5 && outPath.compare(outPath.size() - 5, 5, ".json") == 0;
+    std::ofstream outFile(outPath);
+    if (!outFile.is_open())
+    {
+        LOG(ERROR_SERV(LOG_CLI), "Failed to open output file: " << outPath);
+        return 1;
+    }
+
+    ThreadPool* pool = ThreadPool::getInstance();
+    const size_t maxInFlight = std::max<size_t>(1, pool->GetThreadCount() - 1);
+    const uint64_t seedCount = static_cast<uint64_t>(last) - first + 1;
+    LOG(STATUS_SERV(LOG_CLI), "Farming " << seedCount << " seeds on " << maxInFlight << " threads to " << outPath);
+
+    std::mutex resultsMutex;
+    std::condition_variable resultReady;
+    std::deque<FarmResult> results;
+
+    NullBuffer nullBuffer;
+    std::streambuf* coutBuffer = std::cout.rdbuf(&nullBuffer);
+    std::ostream console(coutBuffer);
+
+    auto startTime = std::chrono::steady_clock::now();
+    Profiler::getInstance()->BeginSession();
+    writeFarmHeader(outFile, json);
+
+    uint64_t submitted = 0, written = 0;
+    size_t inFlight = 0;
+    while (written < seedCount)
+    {
+        // Without pool threads Submit runs the task here, so the lock is not held across it
+        while (inFlight < maxInFlight && submitted < seedCount)
+        {
+            const unsigned int seed = static_cast<unsigned int>(first + submitted);
+            submitted++; inFlight++;
+            pool->Submit([seed, &resultsMutex, &resultReady, &results]()
+            {
+                auto seedStart = std::chrono::steady_clock::now();
+                CityData city = generator::GenerateCityData(seed);
+                FarmResult result = scoreCity(city);
+                result.time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - seedStart).count();
+                result.stages = Profiler::TakeThreadSpanTotals();
+
+                std::lock_guard<std::mutex> lock(resultsMutex);
+                results.push_back(std::move(result));
+                resultReady.notify_one();
+            });
+        }
+
+        std::deque<FarmResult> finished;
+        {
+            std::unique_lock<std::mutex> lock(resultsMutex);
+            resultReady.wait(lock, [&results]{ return !results.empty(); });
+            finished.swap(results);
+        }
+        for (const FarmResult& result : finished)
+        {
+            writeFarmResult(outFile, json, written == 0, result);
+            written++; inFlight--;
+            if (written % 100 == 0)
+            {
+                console << "[" << StopWatch::GetTimeElapsed() << " ms \t]" << STATUS_SERV(LOG_CLI) << written << "/" << seedCount << " seeds" << std::endl;
+            }
+        }
+    }
+
+    if (json) { outFile << "\n]\n"; }
+    Profiler::getInstance()->EndSession();
+    std::cout.rdbuf(coutBuffer);
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    LOG(STATUS_SERV(LOG_CLI), seedCount << " seeds scored in " << seconds << "s, written to " << outPath);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int seed = 0;
+    std::string outPath;
+    size_t threadCount = 0;
+    bool generateChunk = false;
+    ChunkCoord chunk = {0, 0};
+    std::string tracePath;
+    bool useCache = false;
+    bool farm = false;
+    unsigned int farmFirst = 0, farmLast = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--seed") == 0 && i+1 < argc)
+        {
+            seed = std::stoul(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--out") == 0 && i+1 < argc)
+        {
+            outPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && i+1 < argc)
+        {
+            threadCount = std::stoul(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--grammar") == 0 && i+1 < argc)
+        {
+            if (!generator::LoadGrammar(argv[++i]))
+            {
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--chunk") == 0 && i+2 < argc)
+        {
+            generateChunk = true;
+            chunk.x = std::stoi(argv[++i]);
+            chunk.z = std::stoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--trace") == 0 && i+1 < argc)
+        {
+            tracePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--split-crossings") == 0)
+        {
+            generator::SetCrossingPolicy(CrossingPolicy::SPLIT);
+        }
+        else if (std::strcmp(argv[i], "--cache") == 0)
+        {
+            useCache = true;
+        }
+        else if (std::strcmp(argv[i], "--farm") == 0 && i+2 < argc)
+        {
+            farm = true;
+            farmFirst = std::stoul(argv[++i]);
+            farmLast = std::stoul(argv[++i]);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // The output does not depend on the thread count
+    if (threadCount != 0)
+    {
+        ThreadPool::getInstance()->SetThreadCount(threadCount);
+    }
+
+    if (farm)
+    {
+        // Seed 0 would be a new random city each run
+        if (farmFirst == 0 || farmLast < farmFirst)
+        {
+            LOG(ERROR_SERV(LOG_CLI), "Farm seeds must be a range of seeds from 1, got " << farmFirst << " to " << farmLast);
+            return 1;
+        }
+
+        // This thread only waits on the pool, one more pool thread keeps as many cities generating as there are threads
+        ThreadPool::getInstance()->SetThreadCount(ThreadPool::getInstance()->GetThreadCount() + 1);
+        return runSeedFarm(farmFirst, farmLast, outPath.empty() ? "farm_" + std::to_string(farmFirst) + "_" + std::to_string(farmLast) + ".csv" : outPath);
+    }
+
+    // A tiled world needs its seed up front, every chunk is generated from it
+    if (generateChunk && seed == 0)
+    {
+        seed = Random::GenerateSeed();
+    }
+
+    if (!tracePath.empty())
+    {
+        Profiler::getInstance()->BeginSession();
+    }
+
+    CityData city;
+    if (generateChunk)
+    {
+        city = generator::GenerateChunkData(seed, chunk);
+    }
+    else if (!useCache || seed == 0 || !ReadCityCache(generator::GetGenerationKey(seed), city))
+    {
+        city = generator::GenerateCityData(seed);
+        if (useCache) { WriteCityCache(city, generator::GetGenerationKey(city.seed)); }
+    }
+
+    if (!tracePath.empty() && !Profiler::getInstance()->EndSession(tracePath))
+    {
+        return 1;
+    }
+
+    if (outPath.empty())
+    {
+        outPath = generateChunk ? "chunk_" + std::to_string(seed) + "_" + std::to_string(chunk.x) + "_" + std::to_string(chunk.z) + ".json"
+                                : "city_" + std::to_string(city.seed) + ".json";
+    }
+
+    std::ofstream outFile(outPath);
+    if (!outFile.is_open())
+    {
+        LOG(ERROR_SERV(LOG_CLI), "Failed to open output file: " << outPath);
+        return 1;
+    }
+    WriteCityJson(city, outFile);
+
+    LOG(STATUS_SERV(LOG_CLI), "Seed " << city.seed << ": " << city.roads.size() << " roads, "
+        << city.buildings.size() << " buildings, " << city.trees.size() << " trees written to " << outPath);
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <broadPhase.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+void SweepAndPrune(const std::vector<glm::vec2>& min, const std::vector<glm::vec2>& max, BroadPhasePairs& out)
+{
+    const size_t count = min.size();
+    out.offsets.assign(count + 1, 0);
+    out.neighbours.clear();
+
+    // Boxes in order of their minimum x
+    std::vector<uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+    {
+        return min[a].x < min[b].x || (min[a].x == min[b].x && a < b);
+    });
+
+    // Sweep, every box still open when another starts overlaps it on x
+    std::vector<uint32_t> active;
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    for (uint32_t current : order)
+    {
+        const float start = min[current].x;
+        size_t kept = 0;
+        for (uint32_t other : active)
+        {
+            // Closed before this box started, it cannot overlap anything later either
+            if (max[other].x < start)
+                continue;
+
+            active[kept++] = other;
+            if (min[current].y <= max[other].y && min[other].y <= max[current].y)
+            {
+                pairs.push_back({current, other});
+                out.offsets[current + 1]++;
+                out.offsets[other + 1]++;
+            }
+        }
+        active.resize(kept);
+        active.push_back(current);
+    }
+
+    // Both directions of every pair into the CSR rows
+    for (size_t i = 0; i < count; i++)
+    {
+        out.offsets[i + 1] += out.offsets[i];
+    }
+    out.neighbours.resize(out.offsets[count]);
+    std::vector<uint32_t> fill(out.offsets.begin(), out.offsets.end() - 1);
+    for (const auto& pair : pairs)
+    {
+        out.neighbours[fill[pair.first]++] = pair.second;
+        out.neighbours[fill[pair.second]++] = pair.first;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        std::sort(out.neighbours.begin() + out.offsets[i], out.neighbours.begin() + out.offsets[i + 1]);
+    }
+}
@@ -0,0 +1,189 @@
+#include <cityCache.hpp>
+#include <config.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#define LOG_CACHE "CITY CACHE"
+
+// Bump when the layout below changes
+constexpr uint32_t cityCacheFormat = 1;
+constexpr char cityCacheMagic[4] = {'C', 'G', 'C', 'C'};
+
+// Bits of the road flags byte
+enum CachedRoadFlags : uint8_t
+{
+    ROAD_ALLOW_BUILDING_ZONES = 1 << 0,
+    ROAD_CREATE_TREES = 1 << 1,
+    ROAD_ZONE_A_USABLE = 1 << 2,
+    ROAD_ZONE_B_USABLE = 1 << 3
+};
+
+//  magic, format, key, seed, densityFactor, road count, building count, tree count
+//  roads       a, b, width, flags
+//  buildings   modelIndex, position, angle, scale
+//  trees       position
+
+template<typename T>
+inline void writeValue(std::ostream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+inline bool readValue(std::istream& stream, T& value)
+{
+    return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+
+std::string GetCityCachePath(uint64_t key)
+{
+    std::ostringstream path;
+    path << paths::cityCacheDirectory << "/city_" << std::hex;
+    path.width(16);
+    path.fill('0');
+    path << key << ".bin";
+    return path.str();
+}
+
+
+bool WriteCityCache(const CityData& city, uint64_t key)
+{
+    const std::string path = GetCityCachePath(key);
+    std::error_code error;
+    std::filesystem::create_directories(paths::cityCacheDirectory, error);
+
+    // Written next to the file and renamed over it, a reader never sees half a city
+    const std::string partialPath = path + ".partial";
+    {
+        std::ofstream file(partialPath, std::ios::binary);
+        if (!file.is_open())
+        {
+            LOG(ERROR_SERV(LOG_CACHE), "Failed to open cache file: " << partialPath);
+            return false;
+        }
+
+        file.write(cityCacheMagic, sizeof(cityCacheMagic));
+        writeValue(file, cityCacheFormat);
+        writeValue(file, key);
+        writeValue(file, city.seed);
+        writeValue(file, city.densityFactor);
+        writeValue(file, static_cast<uint32_t>(city.roads.size()));
+        writeValue(file, static_cast<uint32_t>(city.buildings.size()));
+        writeValue(file, static_cast<uint32_t>(city.trees.size()));
+
+        for (const CityRoad& road : city.roads)
+        {
+            writeValue(file, road.a);
+            writeValue(file, road.b);
+            writeValue(file, road.width);
+            writeValue(file, static_cast<uint8_t>((road.allowBuildingZones ? ROAD_ALLOW_BUILDING_ZONES : 0) |
+                                                  (road.createTrees ? ROAD_CREATE_TREES : 0) |
+                                                  (road.zoneA.usable ? ROAD_ZONE_A_USABLE : 0) |
+                                                  (road.zoneB.usable ? ROAD_ZONE_B_USABLE : 0)));
+        }
+        for (const CityBuilding& building : city.buildings)
+        {
+            writeValue(file, static_cast<uint32_t>(building.modelIndex));
+            writeValue(file, building.position);
+            writeValue(file, building.angle);
+            writeValue(file, building.scale);
+        }
+        for (const CityTree& tree : city.trees)
+        {
+            writeValue(file, tree.position);
+        }
+
+        if (!file.good())
+        {
+            LOG(ERROR_SERV(LOG_CACHE), "Failed to write cache file: " << partialPath);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(partialPath, path, error);
+    if (error)
+    {
+        LOG(ERROR_SERV(LOG_CACHE), "Failed to move cache file to " << path << ": " << error.message());
+        std::remove(partialPath.c_str());
+        return false;
+    }
+    LOG(STATUS_SERV(LOG_CACHE), "City " << city.seed << " cached to " << path);
+    return true;
+}
+
+
+bool ReadCityCache(uint64_t key, CityData& city)
+{
+    const std::string path = GetCityCachePath(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    char magic[sizeof(cityCacheMagic)];
+    uint32_t format = 0;
+    uint64_t fileKey = 0;
+    CityData cached;
+    uint32_t roadCount = 0, buildingCount = 0, treeCount = 0;
+    if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), cityCacheMagic) ||
+        !readValue(file, format) || format != cityCacheFormat ||
+        !readValue(file, fileKey) || fileKey != key ||
+        !readValue(file, cached.seed) || !readValue(file, cached.densityFactor) ||
+        !readValue(file, roadCount) || !readValue(file, buildingCount) || !readValue(file, treeCount))
+    {
+        LOG(WARN_SERV(LOG_CACHE), "Ignoring cache file that does not match: " << path);
+        return false;
+    }
+
+    // Counts come from the file, the reads below fail on a short file before much is allocated
+    for (uint32_t i = 0; i < roadCount; i++)
+    {
+        glm::vec3 a, b;
+        float width;
+        uint8_t flags;
+        if (!readValue(file, a) || !readValue(file, b) || !readValue(file, width) || !readValue(file, flags))
+            break;
+
+        CityRoad road = CreateCityRoad(a, b, width);
+        road.allowBuildingZones = flags & ROAD_ALLOW_BUILDING_ZONES;
+        road.createTrees = flags & ROAD_CREATE_TREES;
+        road.zoneA.usable = flags & ROAD_ZONE_A_USABLE;
+        road.zoneB.usable = flags & ROAD_ZONE_B_USABLE;
+        cached.roads.push_back(std::move(road));
+    }
+    for (uint32_t i = 0; i < buildingCount && file; i++)
+    {
+        uint32_t modelIndex;
+        CityBuilding building;
+        if (!readValue(file, modelIndex) || modelIndex >= paths::buildingModelPaths.size() ||
+            !readValue(file, building.position) || !readValue(file, building.angle) || !readValue(file, building.scale))
+        {
+            file.setstate(std::ios::failbit);
+            break;
+        }
+        building.modelIndex = modelIndex;
+        cached.buildings.push_back(building);
+    }
+    for (uint32_t i = 0; i < treeCount && file; i++)
+    {
+        CityTree tree;
+        if (!readValue(file, tree.position))
+            break;
+        cached.trees.push_back(tree);
+    }
+
+    if (!file || cached.roads.size() != roadCount || cached.buildings.size() != buildingCount || cached.trees.size() != treeCount)
+    {
+        LOG(WARN_SERV(LOG_CACHE), "Ignoring truncated or corrupt cache file: " << path);
+        return false;
+    }
+
+    BuildCityRoadGraph(&cached);
+    city = std::move(cached);
+    LOG(STATUS_SERV(LOG_CACHE), "City " << city.seed << " read from " << path);
+    return true;
+}
@@ -0,0 +1,95 @@
+#include <cityData.hpp>
+#include <config.hpp>
+
+#include <iomanip>
+
+CityRoad CreateCityRoad(glm::vec3 a, glm::vec3 b, float width)
+{
+    CityRoad road;
+    road.a = a;
+    road.b = b;
+    road.width = width;
+    road.geometry = CalculateRoadGeometry(a, b, width);
+
+    road.zoneA.vertices = road.geometry.leftZone;
+    road.zoneA.areas = CalculatePlacementAreas(road.zoneA.vertices, width);
+
+    road.zoneB.vertices = road.geometry.rightZone;
+    road.zoneB.areas = CalculatePlacementAreas(road.zoneB.vertices, width);
+    return road;
+}
+
+
+CityBuilding CreateCityBuilding(const PlacementArea& area, unsigned int modelIndex)
+{
+    return {modelIndex,
+            area.position,
+            area.angle,
+            glm::vec3{1, 0.5 + (static_cast<float>(area.deepness)/10.0f)*1.2, 1}};
+}
+
+
+void BuildCityRoadGraph(CityData* city)
+{
+    std::vector<glm::vec3> endpoints;
+    endpoints.reserve(city->roads.size() * 2);
+    for (const auto& road : city->roads)
+    {
+        endpoints.push_back(road.a);
+        endpoints.push_back(road.b);
+    }
+    city->graph.Build(endpoints);
+}
+
+
+// Json array for vectors, the ostream operator in config.hpp is for logging
+inline void writeVec3(std::ostream& stream, const glm::vec3& vector)
+{
+    stream << "[" << vector.x << "," << vector.y << "," << vector.z << "]";
+}
+
+void WriteCityJson(const CityData& city, std::ostream& stream)
+{
+    // Enough digits to get the same float back
+    stream << std::setprecision(9);
+
+    stream << "{\n";
+    stream << "  \"seed\": " << city.seed << ",\n";
+    stream << "  \"densityFactor\": " << city.densityFactor << ",\n";
+
+    stream << "  \"roads\": [";
+    for (size_t i = 0; i < city.roads.size(); i++)
+    {
+        const CityRoad& road = city.roads[i];
+        stream << (i == 0 ? "\n" : ",\n") << "    {\"a\": ";
+        writeVec3(stream, road.a);
+        stream << ", \"b\": ";
+        writeVec3(stream, road.b);
+        stream << ", \"width\": " << road.width
+               << ", \"zoneA\": " << (road.zoneA.usable ? "true" : "false")
+               << ", \"zoneB\": " << (road.zoneB.usable ? "true" : "false") << "}";
+    }
+    stream << "\n  ],\n";
+
+    stream << "  \"buildings\": [";
+    for (size_t i = 0; i < city.buildings.size(); i++)
+    {
+        const CityBuilding& building = city.buildings[i];
+        stream << (i == 0 ? "\n" : ",\n") << "    {\"model\": \"" << paths::buildingModelPaths[building.modelIndex] << "\", \"position\": ";
+        writeVec3(stream, building.position);
+        stream << ", \"angle\": " << building.angle << ", \"scale\": ";
+        writeVec3(stream, building.scale);
+        stream << "}";
+    }
+    stream << "\n  ],\n";
+
+    stream << "  \"trees\": [";
+    for (size_t i = 0; i < city.trees.size(); i++)
+    {
+        stream << (i == 0 ? "\n" : ",\n") << "    {\"position\": ";
+        writeVec3(stream, city.trees[i].position);
+        stream << "}";
+    }
+    stream << "\n  ]\n";
+    stream << "}\n";
+}
@@ -0,0 +1,325 @@
+#include <cityEditor.hpp>
+
+#include <generator.hpp>
+#include <config.hpp>
+
+#include <algorithm>
+
+// Roads are a few units long, highways span many cells but there are few of them
+constexpr float editorRoadCellSize = 16.0f;
+
+CityEditor::CityEditor(const CityData& city_in)
+    : city(city_in),
+      roadGrid(editorRoadCellSize),
+      zoneGrid(editorRoadCellSize),
+      candidateGrid(buildingCollisionThresholdDetection)
+{
+    const size_t roadCount = city.roads.size();
+    roadBoxes.reserve(roadCount);
+    roadCircles.reserve(roadCount);
+    for (size_t r = 0; r < roadCount; r++)
+    {
+        // GenerateBuildings marked the areas it looked at, candidates are picked again from free zones
+        for (CityZone* zone : {&city.roads[r].zoneA, &city.roads[r].zoneB})
+        {
+            for (auto& area : zone->areas) { area.isOccupied = false; }
+        }
+
+        roadBoxes.push_back(MakeSATBox(city.roads[r].geometry.obb));
+        roadCircles.push_back(CalculateBoundingCircle(city.roads[r].geometry.obb));
+
+        glm::vec2 min, max;
+        getRoadBounds(r, min, max);
+        roadGrid.Insert(r, min, max);
+        getZoneBounds(r, min, max);
+        zoneGrid.Insert(r, min, max);
+    }
+
+    // Zones are already worked out, only the candidates are needed
+    std::vector<glm::vec3> dirty;
+    for (bool isZoneB : {false, true})
+    {
+        zoneCandidates[isZoneB].resize(roadCount);
+        for (size_t r = 0; r < roadCount; r++)
+        {
+            replaceCandidates(r, isZoneB, dirty, nullptr);
+        }
+    }
+
+    for (uint32_t slot = 0; slot < candidates.size(); slot++)
+    {
+        Candidate& candidate = candidates[slot];
+        candidate.survives = candidate.alive && candidateSurvives(slot);
+        if (candidate.survives)
+        {
+            buildings[candidate.key] = CreateCityBuilding(candidate.area, candidate.model);
+        }
+    }
+
+    for (size_t r = 0; r < roadCount; r++)
+    {
+        addTrees(r, nullptr);
+    }
+}
+
+
+void CityEditor::getRoadBounds(size_t roadIndex, glm::vec2& min, glm::vec2& max) const
+{
+    const auto& obb = city.roads[roadIndex].geometry.obb;
+    min = max = {obb[0].x, obb[0].z};
+    for (const auto& vertex : obb)
+    {
+        min = glm::min(min, glm::vec2{vertex.x, vertex.z});
+        max = glm::max(max, glm::vec2{vertex.x, vertex.z});
+    }
+}
+
+
+void CityEditor::getZoneBounds(size_t roadIndex, glm::vec2& min, glm::vec2& max) const
+{
+    const CityRoad& road = city.roads[roadIndex];
+    min = max = {road.zoneA.vertices[0].x, road.zoneA.vertices[0].z};
+    for (const CityZone* zone : {&road.zoneA, &road.zoneB})
+    {
+        for (const auto& vertex : zone->vertices)
+        {
+            min = glm::min(min, glm::vec2{vertex.x, vertex.z});
+            max = glm::max(max, glm::vec2{vertex.x, vertex.z});
+        }
+    }
+}
+
+
+void CityEditor::calculateZones(size_t roadIndex)
+{
+    CityRoad& road = city.roads[roadIndex];
+    road.zoneA.usable = road.allowBuildingZones;
+    road.zoneB.usable = road.allowBuildingZones;
+    if (!road.allowBuildingZones)
+        return;
+
+    const SATBox zoneA = MakeSATBox(road.zoneA.vertices);
+    const SATBox zoneB = MakeSATBox(road.zoneB.vertices);
+
+    // A road can only collide with a zone if its bounds overlap the zones
+    glm::vec2 min, max;
+    getZoneBounds(roadIndex, min, max);
+    std::vector<uint32_t> nearby;
+    roadGrid.Query(min, max, nearby);
+
+    for (uint32_t j : nearby)
+    {
+        if (j == roadIndex || TooFarForCollision(roadCircles[roadIndex], roadCircles[j], generator::zoneCollisionThreshold))
+            continue;
+
+        if (road.zoneA.usable && IntersectsSAT(zoneA, roadBoxes[j])) { road.zoneA.usable = false; }
+        if (road.zoneB.usable && IntersectsSAT(zoneB, roadBoxes[j])) { road.zoneB.usable = false; }
+        if (!road.zoneA.usable && !road.zoneB.usable)
+            break;
+    }
+}
+
+
+void CityEditor::replaceCandidates(size_t roadIndex, bool isZoneB, std::vector<glm::vec3>& dirty, CityEdit* edit)
+{
+    std::vector<uint32_t>& slots = zoneCandidates[isZoneB][roadIndex];
+    for (uint32_t slot : slots)
+    {
+        Candidate& candidate = candidates[slot];
+        const glm::vec2 position = {candidate.area.position.x, candidate.area.position.z};
+        candidateGrid.Remove(slot, position, position);
+        dirty.push_back(candidate.area.position);
+
+        if (candidate.survives)
+        {
+            buildings.erase(candidate.key);
+            if (edit != nullptr) { edit->removedBuildings.push_back(candidate.key); }
+        }
+        candidate.alive = false;
+        candidate.survives = false;
+        freeCandidates.push_back(slot);
+    }
+    slots.clear();
+
+    CityZone& zone = isZoneB ? city.roads[roadIndex].zoneB : city.roads[roadIndex].zoneA;
+    if (!zone.usable)
+        return;
+
+    for (auto& area : zone.areas) { area.isOccupied = false; }
+    std::vector<uint32_t> areaIndices;
+    generator::SelectBuildingAreas(&city, roadIndex, isZoneB, areaIndices);
+
+    for (uint32_t i : areaIndices)
+    {
+        uint32_t slot;
+        if (!freeCandidates.empty())
+        {
+            slot = freeCandidates.back();
+            freeCandidates.pop_back();
+        }
+        else
+        {
+            slot = candidates.size();
+            candidates.emplace_back();
+        }
+
+        candidates[slot] = {buildingKey(roadIndex, isZoneB, i), zone.areas[i], generator::GetBuildingModelIndex(roadIndex, isZoneB, i), true, false};
+        const glm::vec2 position = {zone.areas[i].position.x, zone.areas[i].position.z};
+        candidateGrid.Insert(slot, position, position);
+        dirty.push_back(zone.areas[i].position);
+        slots.push_back(slot);
+    }
+}
+
+
+bool CityEditor::candidateSurvives(uint32_t slot) const
+{
+    const Candidate& candidate = candidates[slot];
+    const glm::vec2 position = {candidate.area.position.x, candidate.area.position.z};
+    const glm::vec2 range = glm::vec2(buildingCollisionThresholdDetection);
+    std::vector<uint32_t> nearby;
+    candidateGrid.Query(position - range, position + range, nearby);
+
+    // Removed if it intersects any later candidate
+    for (uint32_t other : nearby)
+    {
+        const Candidate& later = candidates[other];
+        if (!later.alive || later.key <= candidate.key || candidate.area.TooFarForCollision(&later.area))
+            continue;
+        if (candidate.area.Intersects(later.area.zoneVerticesArray))
+            return false;
+    }
+    return true;
+}
+
+
+void CityEditor::addTrees(size_t roadIndex, CityEdit* edit)
+{
+    const CityRoad& road = city.roads[roadIndex];
+    if (!road.createTrees)
+        return;
+
+    std::vector<uint32_t> areaIndices;
+    for (bool isZoneB : {false, true})
+    {
+        generator::SelectTreeAreas(city, roadIndex, isZoneB, areaIndices);
+        const CityZone& zone = isZoneB ? road.zoneB : road.zoneA;
+        for (uint32_t i : areaIndices)
+        {
+            const uint64_t key = treeKey(roadIndex, isZoneB, i);
+            trees[key] = {zone.areas[i].position};
+            if (edit != nullptr) { edit->addedTrees.push_back({key, trees[key]}); }
+        }
+    }
+}
+
+
+void CityEditor::removeTrees(size_t roadIndex, CityEdit* edit)
+{
+    auto first = trees.lower_bound(treeKey(roadIndex, false, 0));
+    auto last = trees.lower_bound(treeKey(roadIndex + 1, false, 0));
+    for (auto it = first; it != last; ++it)
+    {
+        edit->removedTrees.push_back(it->first);
+    }
+    trees.erase(first, last);
+}
+
+
+CityEdit CityEditor::UpdateRoad(size_t roadIndex, glm::vec3 a, glm::vec3 b, float width)
+{
+    CityEdit edit;
+
+    // Take the old road out of the grids
+    glm::vec2 oldMin, oldMax, oldZoneMin, oldZoneMax;
+    getRoadBounds(roadIndex, oldMin, oldMax);
+    getZoneBounds(roadIndex, oldZoneMin, oldZoneMax);
+    roadGrid.Remove(roadIndex, oldMin, oldMax);
+    zoneGrid.Remove(roadIndex, oldZoneMin, oldZoneMax);
+    removeTrees(roadIndex, &edit);
+
+    CityRoad road = CreateCityRoad(a, b, width);
+    road.allowBuildingZones = city.roads[roadIndex].allowBuildingZones;
+    road.createTrees = city.roads[roadIndex].createTrees;
+    city.roads[roadIndex] = road;
+    roadBoxes[roadIndex] = MakeSATBox(road.geometry.obb);
+    roadCircles[roadIndex] = CalculateBoundingCircle(road.geometry.obb);
+
+    glm::vec2 newMin, newMax, newZoneMin, newZoneMax;
+    getRoadBounds(roadIndex, newMin, newMax);
+    getZoneBounds(roadIndex, newZoneMin, newZoneMax);
+    roadGrid.Insert(roadIndex, newMin, newMax);
+    zoneGrid.Insert(roadIndex, newZoneMin, newZoneMax);
+
+    // Zones the old or the new road can touch, and the zones of the road itself
+    std::vector<uint32_t> affected, found;
+    zoneGrid.Query(oldMin, oldMax, found);
+    affected.insert(affected.end(), found.begin(), found.end());
+    zoneGrid.Query(newMin, newMax, found);
+    affected.insert(affected.end(), found.begin(), found.end());
+    affected.push_back(roadIndex);
+    std::sort(affected.begin(), affected.end());
+    affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+
+    // Zones that changed get new candidates
+    std::vector<glm::vec3> dirty;
+    for (uint32_t r : affected)
+    {
+        const bool usableA = city.roads[r].zoneA.usable;
+        const bool usableB = city.roads[r].zoneB.usable;
+        calculateZones(r);
+
+        if (r == roadIndex || usableA != city.roads[r].zoneA.usable)
+            replaceCandidates(r, false, dirty, &edit);
+        if (r == roadIndex || usableB != city.roads[r].zoneB.usable)
+            replaceCandidates(r, true, dirty, &edit);
+        edit.zoneRoads.push_back(r);
+    }
+    addTrees(roadIndex, &edit);
+
+    // Only candidates near the ones that changed can have been removed by them or have removed them
+    std::vector<uint32_t> recheck;
+    const glm::vec2 range = glm::vec2(buildingCollisionThresholdDetection);
+    for (const auto& point : dirty)
+    {
+        const glm::vec2 position = {point.x, point.z};
+        candidateGrid.Query(position - range, position + range, found);
+        recheck.insert(recheck.end(), found.begin(), found.end());
+    }
+    std::sort(recheck.begin(), recheck.end());
+    recheck.erase(std::unique(recheck.begin(), recheck.end()), recheck.end());
+
+    for (uint32_t slot : recheck)
+    {
+        Candidate& candidate = candidates[slot];
+        const bool survives = candidateSurvives(slot);
+        if (survives == candidate.survives)
+            continue;
+
+        candidate.survives = survives;
+        if (survives)
+        {
+            buildings[candidate.key] = CreateCityBuilding(candidate.area, candidate.model);
+            edit.addedBuildings.push_back({candidate.key, buildings[candidate.key]});
+        }
+        else
+        {
+            buildings.erase(candidate.key);
+            edit.removedBuildings.push_back(candidate.key);
+        }
+    }
+
+    return edit;
+}
+
+
+CityData CityEditor::GetCityData(void) const
+{
+    CityData edited = city;
+    edited.buildings.clear();
+    edited.trees.clear();
+    for (const auto& building : buildings) { edited.buildings.push_back(building.second); }
+    for (const auto& tree : trees) { edited.trees.push_back(tree.second); }
+    BuildCityRoadGraph(&edited);
+    return edited;
+}
@@ -0,0 +1,304 @@
+#include <citySnapshot.hpp>
+#include <config.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#if defined(_WIN32)
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define LOG_SNAPSHOT "CITY SNAPSHOT"
+
+// Bump when the layout below changes
+constexpr uint32_t citySnapshotFormat = 1;
+constexpr char citySnapshotMagic[4] = {'C', 'G', 'S', 'N'};
+constexpr uint64_t citySnapshotAlignment = 16;
+
+//  header, then each array at its offset
+//  road points         2 * roadCount vec3
+//  road widths         roadCount float
+//  road zone bits      roadCount uint8
+//  model ranges        modelCount (first, count) uint32 pairs into the building transforms
+//  building transforms buildingCount mat4, grouped by model
+//  tree positions      treeCount vec3
+struct CitySnapshotHeader
+{
+    char magic[4];
+    uint32_t format;
+    uint32_t seed;
+    uint32_t roadCount;
+    uint32_t modelCount;
+    uint32_t buildingCount;
+    uint32_t treeCount;
+    uint32_t reserved;
+
+    uint64_t roadPoints;
+    uint64_t roadWidths;
+    uint64_t roadZoneBits;
+    uint64_t modelRanges;
+    uint64_t buildingTransforms;
+    uint64_t treePositions;
+    uint64_t fileSize;
+};
+
+struct CitySnapshotModelRange
+{
+    uint32_t first;
+    uint32_t count;
+};
+
+static uint64_t alignOffset(uint64_t offset)
+{
+    return (offset + citySnapshotAlignment - 1) / citySnapshotAlignment * citySnapshotAlignment;
+}
+
+
+bool WriteCitySnapshot(const std::string& path, const CitySnapshotContents& contents)
+{
+    const uint32_t roadCount = contents.roadWidths.size();
+    if (contents.roadPoints.size() != roadCount * 2 || contents.roadZoneBits.size() != roadCount)
+    {
+        LOG(ERROR_SERV(LOG_SNAPSHOT), "Road arrays of the snapshot do not match in size");
+        return false;
+    }
+
+    CitySnapshotHeader header = {};
+    std::copy(citySnapshotMagic, citySnapshotMagic + sizeof(citySnapshotMagic), header.magic);
+    header.format = citySnapshotFormat;
+    header.seed = contents.seed;
+    header.roadCount = roadCount;
+    header.modelCount = contents.buildingTransforms.size();
+    header.treeCount = contents.treePositions.size();
+
+    std::vector<CitySnapshotModelRange> ranges;
+    for (const auto& transforms : contents.buildingTransforms)
+    {
+        ranges.push_back({header.buildingCount, static_cast<uint32_t>(transforms.size() / 16)});
+        header.buildingCount += ranges.back().count;
+    }
+
+    // Lay the arrays out one after the other
+    uint64_t offset = sizeof(CitySnapshotHeader);
+    auto place = [&](uint64_t bytes)
+    {
+        const uint64_t start = alignOffset(offset);
+        offset = start + bytes;
+        return start;
+    };
+    header.roadPoints = place(contents.roadPoints.size() * sizeof(glm::vec3));
+    header.roadWidths = place(roadCount * sizeof(float));
+    header.roadZoneBits = place(roadCount * sizeof(uint8_t));
+    header.modelRanges = place(ranges.size() * sizeof(CitySnapshotModelRange));
+    header.buildingTransforms = place(uint64_t(header.buildingCount) * 16 * sizeof(float));
+    header.treePositions = place(contents.treePositions.size() * sizeof(glm::vec3));
+    header.fileSize = offset;
+
+    // Written next to the file and renamed over it, like the city cache
+    const std::string partialPath = path + ".partial";
+    {
+        std::ofstream file(partialPath, std::ios::binary);
+        if (!file.is_open())
+        {
+            LOG(ERROR_SERV(LOG_SNAPSHOT), "Failed to open snapshot file: " << partialPath);
+            return false;
+        }
+
+        uint64_t written = 0;
+        auto write = [&](uint64_t start, const void* bytes, uint64_t count)
+        {
+            static const char padding[citySnapshotAlignment] = {};
+            file.write(padding, start - written);
+            file.write(static_cast<const char*>(bytes), count);
+            written = start + count;
+        };
+        write(0, &header, sizeof(header));
+        write(header.roadPoints, contents.roadPoints.data(), contents.roadPoints.size() * sizeof(glm::vec3));
+        write(header.roadWidths, contents.roadWidths.data(), roadCount * sizeof(float));
+        write(header.roadZoneBits, contents.roadZoneBits.data(), roadCount * sizeof(uint8_t));
+        write(header.modelRanges, ranges.data(), ranges.size() * sizeof(CitySnapshotModelRange));
+        for (size_t model = 0; model < contents.buildingTransforms.size(); model++)
+        {
+            const uint64_t start = header.buildingTransforms + uint64_t(ranges[model].first) * 16 * sizeof(float);
+            write(start, contents.buildingTransforms[model].data(), uint64_t(ranges[model].count) * 16 * sizeof(float));
+        }
+        write(header.treePositions, contents.treePositions.data(), contents.treePositions.size() * sizeof(glm::vec3));
+
+        if (!file.good())
+        {
+            LOG(ERROR_SERV(LOG_SNAPSHOT), "Failed to write snapshot file: " << partialPath);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(partialPath, path, error);
+    if (error)
+    {
+        LOG(ERROR_SERV(LOG_SNAPSHOT), "Failed to move snapshot file to " << path << ": " << error.message());
+        std::remove(partialPath.c_str());
+        return false;
+    }
+    LOG(STATUS_SERV(LOG_SNAPSHOT), "City " << contents.seed << " saved to " << path << " (" << roadCount << " roads, "
+        << header.buildingCount << " buildings, " << header.treeCount << " trees)");
+    return true;
+}
+
+
+CitySnapshot::~CitySnapshot()
+{
+    Close();
+}
+
+
+void CitySnapshot::Close(void)
+{
+#if !defined(_WIN32)
+    if (mapped)
+    {
+        munmap(const_cast<char*>(data), size);
+    }
+#endif
+    mapped = false;
+    data = nullptr;
+    size = 0;
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
+
+
+bool CitySnapshot::Open(const std::string& path)
+{
+    Close();
+
+#if defined(_WIN32)
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+#else
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+    struct stat status;
+    if (fstat(file, &status) == 0 && status.st_size > 0)
+    {
+        void* map = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (map != MAP_FAILED)
+        {
+            // The whole file is read once on load, ask for it up front
+            madvise(map, status.st_size, MADV_WILLNEED);
+            data = static_cast<const char*>(map);
+            size = status.st_size;
+            mapped = true;
+        }
+    }
+    close(file);
+    if (!mapped)
+    {
+        LOG(ERROR_SERV(LOG_SNAPSHOT), "Failed to map snapshot file: " << path);
+        return false;
+    }
+#endif
+
+    // Every array has to be inside the file before any of the getters hand out a pointer to it
+    const CitySnapshotHeader* header = at<CitySnapshotHeader>(0);
+    auto fits = [&](uint64_t offset, uint64_t bytes)
+    {
+        return offset % citySnapshotAlignment == 0 && offset <= size && bytes <= size - offset;
+    };
+    bool valid = size >= sizeof(CitySnapshotHeader) &&
+        std::equal(citySnapshotMagic, citySnapshotMagic + sizeof(citySnapshotMagic), header->magic) &&
+        header->format == citySnapshotFormat && header->fileSize == size &&
+        fits(header->roadPoints, uint64_t(header->roadCount) * 2 * sizeof(glm::vec3)) &&
+        fits(header->roadWidths, uint64_t(header->roadCount) * sizeof(float)) &&
+        fits(header->roadZoneBits, uint64_t(header->roadCount) * sizeof(uint8_t)) &&
+        fits(header->modelRanges, uint64_t(header->modelCount) * sizeof(CitySnapshotModelRange)) &&
+        fits(header->buildingTransforms, uint64_t(header->buildingCount) * 16 * sizeof(float)) &&
+        fits(header->treePositions, uint64_t(header->treeCount) * sizeof(glm::vec3));
+    if (valid)
+    {
+        const CitySnapshotModelRange* ranges = at<CitySnapshotModelRange>(header->modelRanges);
+        for (uint32_t model = 0; model < header->modelCount && valid; model++)
+        {
+            valid = ranges[model].first <= header->buildingCount && ranges[model].count <= header->buildingCount - ranges[model].first;
+        }
+    }
+    if (!valid)
+    {
+        LOG(WARN_SERV(LOG_SNAPSHOT), "Ignoring snapshot file that does not match the format: " << path);
+        Close();
+        return false;
+    }
+
+    LOG(STATUS_SERV(LOG_SNAPSHOT), "Opened " << path << " (" << header->roadCount << " roads, "
+        << header->buildingCount << " buildings, " << header->treeCount << " trees)");
+    return true;
+}
+
+
+unsigned int CitySnapshot::GetSeed(void) const
+{
+    return at<CitySnapshotHeader>(0)->seed;
+}
+
+
+uint32_t CitySnapshot::GetRoadCount(void) const
+{
+    return at<CitySnapshotHeader>(0)->roadCount;
+}
+
+
+const glm::vec3* CitySnapshot::GetRoadPoints(void) const
+{
+    return at<glm::vec3>(at<CitySnapshotHeader>(0)->roadPoints);
+}
+
+
+const float* CitySnapshot::GetRoadWidths(void) const
+{
+    return at<float>(at<CitySnapshotHeader>(0)->roadWidths);
+}
+
+
+const uint8_t* CitySnapshot::GetRoadZoneBits(void) const
+{
+    return at<uint8_t>(at<CitySnapshotHeader>(0)->roadZoneBits);
+}
+
+
+uint32_t CitySnapshot::GetModelCount(void) const
+{
+    return at<CitySnapshotHeader>(0)->modelCount;
+}
+
+
+const float* CitySnapshot::GetBuildingTransforms(uint32_t model, uint32_t* count) const
+{
+    const CitySnapshotHeader* header = at<CitySnapshotHeader>(0);
+    const CitySnapshotModelRange& range = at<CitySnapshotModelRange>(header->modelRanges)[model];
+    *count = range.count;
+    return at<float>(header->buildingTransforms) + uint64_t(range.first) * 16;
+}
+
+
+uint32_t CitySnapshot::GetTreeCount(void) const
+{
+    return at<CitySnapshotHeader>(0)->treeCount;
+}
+
+
+const glm::vec3* CitySnapshot::GetTreePositions(void) const
+{
+    return at<glm::vec3>(at<CitySnapshotHeader>(0)->treePositions);
+}
@@ -0,0 +1,1607 @@
+#include <generator.hpp>
+
+#include <config.hpp>
+#include <glm/exponential.hpp>
+#include <cityRandom.hpp>
+#include <stopwatch.hpp>
+#include <spatialGrid.hpp>
+#include <threadPool.hpp>
+#include <lSystem.hpp>
+#include <satBatch.hpp>
+#include <broadPhase.hpp>
+#include <segmentBvh.hpp>
+#include <profiler.hpp>
+
+// STD
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <stack>
+#include <string_view>
+#include <unordered_set>
+
+// Macro for logging
+#define LOG_GEN "GENERATOR"
+
+// Helper function
+// Checks if the distance between two points is less than a threshold value in the XZ plane
+// Road length has to scale with the threshold value
+inline bool inRangeXZPlane(const road_gen_point& a, const road_gen_point& b, float thresholdUpper, float thresholdLower, const float roadWidth, const float roadLength){
+    if (thresholdLower < roadWidth)
+        thresholdLower = roadWidth;
+
+    float distance = glm::sqrt(glm::pow(a.point.x - b.point.x, 2.0f) + glm::pow(a.point.z - b.point.z, 2.0f));
+    // If close enough and as far away as road width
+    if (distance > thresholdUpper*roadLength || distance < thresholdLower){
+        return false;
+    }    
+    return true;
+}
+
+
+// Random streams of a seed, every stage draws from its own stream so stages do not
+// shift each others numbers. City i draws its roads from STREAM_CITY_ROADS + i
+enum GeneratorStream : uint32_t
+{
+    STREAM_CITY_PARAMETERS = 0,
+    STREAM_TREES = 1,
+    STREAM_BUILDINGS = 2,
+    STREAM_CITY_ROADS = 16
+};
+
+// Start of the stream index range of one zone, zones draw from their own range so they can be done in any order
+inline uint64_t zoneStreamIndex(size_t roadIndex, bool isZoneB)
+{
+    return (static_cast<uint64_t>(roadIndex) << 32) | (static_cast<uint64_t>(isZoneB) << 31);
+}
+
+struct CityGenerationParameters
+{
+    glm::vec3 startPosition;
+    float startAngle;
+    int iterations;         // 2-5
+    float roadLength;       //  
+    float roadWidth;
+    float lowerConnectionThreshold;
+    float upperConnectionThreshold;
+    float roadAngleDegrees;
+};
+
+
+// Intersection tests have a tolerance of 0.001, pad the grid bounds so no candidate is missed
+constexpr float intersectionGridPadding = 0.01f;
+
+
+// @brief Creates long roads between cities
+// End nodes of each city are found through a grid over their positions and the intersection tests
+// only look at the roads a BVH over the road bounds finds along the highway
+// @args roads - dynamic array of all generated roads, will add the highways to this if any created
+// @args endNodes - 2D dynamic array of all the end nodes of each city so we can create highways between different cities
+// @args closest - the minimum amount of distance between two end nodes to consider creating a highway
+// @args furthest - the furthest amount of distance between two end nodes to conisder creating a highway
+void createHighways(std::vector<road_gen_road>* roads, std::vector<std::vector<road_gen_point>>* endNodes, float closest, float furthest, float roadWidth)
+{
+    PROFILE_SCOPE("createHighways");
+    // Set our quota of highways to 8, at 8 we stop
+    int quota = 1;
+    int highwayCount = 0;
+    int64_t roadsTested = 0, intersectionsRejected = 0;
+
+    // We cannot create highways between less than 2 cites.
+    if (endNodes->size() < 2)
+        return;
+
+    // End nodes of each city, the cell size is the furthest highway so a query only covers 3x3 cells
+    std::vector<SpatialGrid> pointGrids(endNodes->size(), SpatialGrid(furthest));
+    for (size_t c = 0; c < endNodes->size(); c++)
+    {
+        for (uint32_t i = 0; i < endNodes->at(c).size(); i++)
+        {
+            glm::vec2 position = {endNodes->at(c)[i].point.x, endNodes->at(c)[i].point.z};
+            pointGrids[c].Insert(i, position, position);
+        }
+    }
+
+    // Roads the highways may cross, the highways created here are few and checked on their own
+    std::vector<glm::vec2> roadsMin(roads->size()), roadsMax(roads->size());
+    for (uint32_t i = 0; i < roads->size(); i++)
+    {
+        GetSegmentBoundsXZ(roads->at(i).a, roads->at(i).b, intersectionGridPadding, roadsMin[i], roadsMax[i]);
+    }
+    SegmentBVH roadTree;
+    roadTree.Build(roadsMin, roadsMax);
+    std::vector<uint32_t> highways;
+
+    std::vector<uint32_t> nearbyPoints;
+    std::vector<uint32_t> blockingRoads;
+
+    // For each set of city end nodes which are not the same city
+    for (unsigned int i = 0; i < endNodes->size(); i++)
+    {
+        for (unsigned int j = i+1; j < endNodes->size(); j++)
+        {
+            int interCityHighways = 0;
+            std::vector<road_gen_point>& cityA = endNodes->at(i);
+            std::vector<road_gen_point>& cityB = endNodes->at(j);
+
+            // Attempt to create highways
+            for(unsigned int k = 0; k < cityA.size(); k++)
+            {
+                // Keep the number low for between cities
+                if (interCityHighways >= quota)
+                    break;
+
+                auto& pointA = cityA[k];
+                if (pointA.endNodeUsed || pointA.hasHighway)
+                    continue;
+
+                // Candidates come back in index order, the same order as scanning every node
+                glm::vec2 position = {pointA.point.x, pointA.point.z};
+                blockingRoads.clear();
+                pointGrids[j].Query(position - glm::vec2(furthest), position + glm::vec2(furthest), nearbyPoints);
+
+                for (uint32_t l : nearbyPoints)
+                {
+                    auto& pointB = cityB[l];
+                    if (inRangeXZPlane(pointA, pointB, furthest, closest, roadWidth, 1.0f) && 
+                        !pointB.endNodeUsed && !pointB.hasHighway)
+                    {
+                        // Create temporary road
+                        road_gen_road tempRoad = {pointA.point, pointB.point, roadWidth*1.5f};
+                        tempRoad.allowBuildingZones = false;
+                        tempRoad.createTrees = true;
+
+                        uint32_t blocking = UINT32_MAX;
+                        auto intersects = [&](uint32_t road)
+                        {
+                            roadsTested++;
+                            if (!tempRoad.isInterceptingAndNodes(roads->at(road)))
+                                return false;
+                            blocking = road;
+                            return true;
+                        };
+                        // If intersects then we look at next point. Highways from one end node are mostly blocked
+                        // by the same few roads of its own city, the last ones found are tried before the tree
+                        // which then visits the roads near A first
+                        if (std::any_of(blockingRoads.begin(), blockingRoads.end(), intersects) ||
+                            roadTree.Query({tempRoad.a.x, tempRoad.a.z}, {tempRoad.b.x, tempRoad.b.z}, intersects) ||
+                            std::any_of(highways.begin(), highways.end(), intersects))
+                        {
+                            intersectionsRejected++;
+                            if (std::find(blockingRoads.begin(), blockingRoads.end(), blocking) == blockingRoads.end())
+                            {
+                                blockingRoads.insert(blockingRoads.begin(), blocking);
+                                if (blockingRoads.size() > 4) { blockingRoads.pop_back(); }
+                            }
+                        }
+                        // If no intersections we add directy to endPoints
+                        else
+                        {
+                            // Add to vector
+                            roads->push_back(tempRoad);
+                            highways.push_back(roads->size()-1);
+                            interCityHighways++; highwayCount++;
+
+                            pointA.hasHighway = true; pointB.hasHighway = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    PROFILE_COUNTER("roads tested", roadsTested);
+    PROFILE_COUNTER("intersections rejected", intersectionsRejected);
+    PROFILE_COUNTER("highways created", highwayCount);
+    LOG(STATUS, "[" << highwayCount << "] : New highways created.");
+}
+
+
+
+
+// Endpoint quantization for the duplicate hash, 1/1024 is finer than the road intersection tolerance
+constexpr float dupeQuantization = 1024.0f;
+
+inline uint64_t hashQuantizedPoint(const glm::vec3& point)
+{
+    uint64_t hash = 14695981039346656037ull; // FNV-1a
+    for (int i = 0; i < 3; i++)
+    {
+        hash ^= static_cast<uint64_t>(static_cast<int64_t>(std::llround(point[i] * dupeQuantization)));
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Same hash for A-B and B-A
+inline uint64_t hashRoadEndpoints(const road_gen_road& road)
+{
+    uint64_t hashA = hashQuantizedPoint(road.a), hashB = hashQuantizedPoint(road.b);
+    uint64_t hash = glm::min(hashA, hashB) * 0x9E3779B97F4A7C15ull ^ glm::max(hashA, hashB);
+    return hash ^ (hash >> 29);
+}
+
+inline bool sameEndpoints(const road_gen_road& lhs, const road_gen_road& rhs)
+{
+    return (lhs.a == rhs.a && lhs.b == rhs.b) || (lhs.a == rhs.b && lhs.b == rhs.a);
+}
+
+// @brief removes roads that are the same i.e. overlapping, A-B and B-A count as the same road
+// The first of each set of duplicates is kept and the survivors keep their order
+// @args roadsVector is the vector of roads created originally and is updated by this method
+void removeDupes(std::vector<road_gen_road>* roadsVector)
+{
+    PROFILE_SCOPE("removeDupes");
+    const uint32_t roadCount = roadsVector->size();
+    constexpr uint32_t emptySlot = UINT32_MAX;
+
+    // Open addressing table of indices into the kept roads, linear probing at under half load
+    uint32_t capacity = 16;
+    while (capacity < roadCount * 2) { capacity <<= 1; }
+    std::vector<uint32_t> table(capacity, emptySlot);
+    const uint32_t mask = capacity - 1;
+
+    // Single compaction pass, kept roads are moved to the front as we go
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < roadCount; i++)
+    {
+        const road_gen_road& road = (*roadsVector)[i];
+        uint32_t slot = hashRoadEndpoints(road) & mask;
+        bool isDupe = false;
+
+        while (table[slot] != emptySlot)
+        {
+            // Quantized hashes only pick the bucket, the endpoints still have to match exactly
+            if (sameEndpoints((*roadsVector)[table[slot]], road))
+            {
+                isDupe = true;
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+
+        if (!isDupe)
+        {
+            (*roadsVector)[kept] = road;
+            table[slot] = kept++;
+        }
+    }
+
+    unsigned int removedRoadsDupes = roadCount - kept;
+    roadsVector->resize(kept);
+    PROFILE_COUNTER("roads tested", roadCount);
+    PROFILE_COUNTER("duplicates removed", removedRoadsDupes);
+
+    // The numbers will alter based on the length of the roads due to the grammar
+    LOG(STATUS, "[" << removedRoadsDupes << "] roads removed due to duplicates.");
+}
+
+// @brief Creates new roads from the vector of end nodes
+// if a and b are not the same, not used by another node, are close enough and do not intersect other roads
+// End nodes are found through a grid over their positions and the intersection tests only look at
+// the roads in the cells the new road overlaps
+// @args roadsVector Vector of current generated roads
+// @args endPoints vector of nodes designated as end nodes and are open for connections
+// @args roadWidth 
+// @args roadLength
+void createNewRoads(std::vector<road_gen_road>* roadsVector, 
+                    std::vector<road_gen_point>* endPoints, 
+                    float roadWidth, 
+                    float roadLength, 
+                    float lowerConnectionThreshold, 
+                    float upperConnectionThreshold
+){
+    PROFILE_SCOPE("createNewRoads");
+    unsigned int endNodeConnections = 0;
+    int64_t roadsTested = 0, intersectionsRejected = 0;
+
+    // Furthest a connection can be, the cell size is set to this so a query only covers 3x3 cells
+    const float connectionRadius = upperConnectionThreshold * roadLength;
+    const float cellSize = glm::max(connectionRadius, roadWidth);
+
+    SpatialGrid pointGrid(cellSize);
+    for (uint32_t i = 0; i < endPoints->size(); i++)
+    {
+        glm::vec2 position = {endPoints->at(i).point.x, endPoints->at(i).point.z};
+        pointGrid.Insert(i, position, position);
+    }
+
+    SpatialGrid roadGrid(cellSize);
+    auto insertRoad = [&](uint32_t index)
+    {
+        glm::vec2 min, max;
+        GetSegmentBoundsXZ(roadsVector->at(index).a, roadsVector->at(index).b, intersectionGridPadding, min, max);
+        roadGrid.Insert(index, min, max);
+    };
+    for (uint32_t i = 0; i < roadsVector->size(); i++)
+    {
+        insertRoad(i);
+    }
+
+    std::vector<uint32_t> nearbyPoints;
+    std::vector<uint32_t> nearbyRoads;
+    for (uint32_t i = 0; i < endPoints->size(); i++)
+    {
+        road_gen_point& pointA = endPoints->at(i);
+        if (pointA.endNodeUsed)
+            continue;
+
+        // Candidates come back in index order, the same order as scanning every node
+        glm::vec2 position = {pointA.point.x, pointA.point.z};
+        pointGrid.Query(position - glm::vec2(connectionRadius), position + glm::vec2(connectionRadius), nearbyPoints);
+
+        for (uint32_t j : nearbyPoints)
+        {
+            road_gen_point& pointB = endPoints->at(j);
+
+            // Not looking at the same nodes and they have not already been used
+            if (i == j || pointA.endNodeUsed || pointB.endNodeUsed)
+                continue;
+
+            if (inRangeXZPlane(pointA, pointB, upperConnectionThreshold, lowerConnectionThreshold, roadWidth, roadLength))
+            {
+                // Create temporary road
+                road_gen_road tempRoad = {pointA.point, pointB.point, roadWidth};
+
+                glm::vec2 min, max;
+                GetSegmentBoundsXZ(tempRoad.a, tempRoad.b, intersectionGridPadding, min, max);
+                roadGrid.Query(min, max, nearbyRoads);
+
+                bool endNodeRoadIntersection = false; // used to exit deeply nested loops
+                for (uint32_t road : nearbyRoads)
+                {
+                    roadsTested++;
+                    // If intersects then we look at next point
+                    if (tempRoad.isInterceptingAndNodes(roadsVector->at(road)))
+                    {
+                        endNodeRoadIntersection = true;
+                        intersectionsRejected++;
+                        break;
+                    }
+                }
+                // If no intersections we add directy to endPoints
+                if (!endNodeRoadIntersection)
+                {
+                    // Add to vector
+                    roadsVector->push_back(tempRoad);
+                    insertRoad(roadsVector->size()-1);
+                    // Set nodes to used
+                    pointA.endNodeUsed = true; pointB.endNodeUsed = true;
+                    endNodeConnections++;
+                }
+            }
+        }
+    }
+
+    PROFILE_COUNTER("roads tested", roadsTested);
+    PROFILE_COUNTER("intersections rejected", intersectionsRejected);
+    PROFILE_COUNTER("roads created", endNodeConnections);
+    LOG(STATUS, "[" << endNodeConnections << "] new roads created from end node connections.");
+}
+
+
+
+// @brief Removes roads that intersect other roads, each road only tests the roads in its grid cells
+// Removed roads are tombstoned and compacted once at the end instead of erased from the vector
+// @args roadsVector - roads to cull, updated by this method keeping the order of the survivors
+// @args cellSize - grid cell size, the road length works well
+void cullIntersectingRoads(std::vector<road_gen_road>& roadsVector, float cellSize)
+{
+    PROFILE_SCOPE("cullIntersectingRoads");
+    const uint32_t roadCount = roadsVector.size();
+    std::vector<bool> removed(roadCount, false);
+
+    SpatialGrid grid(cellSize);
+    std::vector<glm::vec2> boundsMin(roadCount), boundsMax(roadCount);
+    for (uint32_t i = 0; i < roadCount; i++)
+    {
+        GetSegmentBoundsXZ(roadsVector[i].a, roadsVector[i].b, intersectionGridPadding, boundsMin[i], boundsMax[i]);
+        grid.Insert(i, boundsMin[i], boundsMax[i]);
+    }
+
+    // Next road after i that has not been removed, roadCount if none
+    auto nextAlive = [&](uint32_t i)
+    {
+        do { i++; } while (i < roadCount && removed[i]);
+        return i;
+    };
+
+    std::vector<uint32_t> candidates;
+    uint32_t i = 0;
+    while (i < roadCount)
+    {
+        grid.Query(boundsMin[i], boundsMax[i], candidates);
+        size_t c = 0;
+        while (c < candidates.size())
+        {
+            const uint32_t j = candidates[c++];
+            if (removed[j] || !roadsVector[i].isInterceptingAndNodes(roadsVector[j]))
+                continue;
+
+            removed[j] = true;
+            grid.Remove(j, boundsMin[j], boundsMax[j]);
+
+            // The previous cull erased j while iterating, when j was before i that moved i onto the
+            // next road for the rest of its scan. Kept so existing seeds generate the same cities.
+            if (j < i)
+            {
+                i = nextAlive(i);
+                if (i >= roadCount)
+                    break;
+
+                // Carry on scanning after j with the new road
+                grid.Query(boundsMin[i], boundsMax[i], candidates);
+                c = std::upper_bound(candidates.begin(), candidates.end(), j) - candidates.begin();
+            }
+        }
+        if (i >= roadCount)
+            break;
+        i = nextAlive(i);
+    }
+
+    // Single compaction pass
+    uint32_t kept = 0;
+    for (uint32_t r = 0; r < roadCount; r++)
+    {
+        if (!removed[r])
+        {
+            roadsVector[kept++] = roadsVector[r];
+        }
+    }
+    PROFILE_COUNTER("roads tested", roadCount);
+    PROFILE_COUNTER("roads removed", roadCount - kept);
+    roadsVector.resize(kept);
+}
+
+
+// @brief Where two roads cross on the xz plane, ends closer than roadWeldTolerance to the crossing count as on it
+// @args point - the crossing, an end of a road when the crossing is at that end so both roads share it exactly
+// @args interior1 - the crossing is inside road1, not at one of its ends
+// @args interior2 - the crossing is inside road2, not at one of its ends
+// @returns false if the roads do not cross, are parallel or already meet at their ends
+bool findCrossing(const road_gen_road& road1, const road_gen_road& road2, glm::vec3& point, bool& interior1, bool& interior2)
+{
+    const glm::vec2 p = {road1.a.x, road1.a.z}, r = glm::vec2{road1.b.x, road1.b.z} - p;
+    const glm::vec2 q = {road2.a.x, road2.a.z}, s = glm::vec2{road2.b.x, road2.b.z} - q;
+    const float length1 = glm::length(r), length2 = glm::length(s);
+
+    // Sine of the angle between the roads, roads continuing in a straight line are parallel within float error
+    // and their crossing would be anywhere along them
+    const float denominator = r.x*s.y - r.y*s.x;
+    if (std::abs(denominator) <= 1e-4f * length1 * length2)
+        return false;
+
+    const glm::vec2 qp = q - p;
+    const float t = (qp.x*s.y - qp.y*s.x) / denominator;
+    const float u = (qp.x*r.y - qp.y*r.x) / denominator;
+
+    // Distances along each road to its nearest end, negative outside the road
+    const float inside1 = glm::min(t, 1 - t) * length1, inside2 = glm::min(u, 1 - u) * length2;
+    if (inside1 < -roadWeldTolerance || inside2 < -roadWeldTolerance)
+        return false;
+
+    interior1 = inside1 > roadWeldTolerance;
+    interior2 = inside2 > roadWeldTolerance;
+    if (!interior1 && !interior2)
+        return false;
+
+    if (!interior2)
+        point = (u < 0.5f) ? road2.a : road2.b;
+    else if (!interior1)
+        point = (t < 0.5f) ? road1.a : road1.b;
+    else
+        point = road1.a + t*(road1.b - road1.a);
+    return true;
+}
+
+
+// @brief Splits roads where they cross so every crossing becomes a junction both roads end at
+// Crossings are found through a grid over the road bounds and each pair is only tested once.
+// The point of a crossing is shared by the pieces of both roads so their ends match exactly
+// @args roadsVector - roads to split, each split road is replaced in place by its pieces
+// @args cellSize - grid cell size, the road length works well
+void splitCrossingRoads(std::vector<road_gen_road>& roadsVector, float cellSize)
+{
+    PROFILE_SCOPE("splitCrossingRoads");
+    const uint32_t roadCount = roadsVector.size();
+
+    SpatialGrid grid(cellSize);
+    std::vector<glm::vec2> boundsMin(roadCount), boundsMax(roadCount);
+    for (uint32_t i = 0; i < roadCount; i++)
+    {
+        GetSegmentBoundsXZ(roadsVector[i].a, roadsVector[i].b, intersectionGridPadding + roadWeldTolerance, boundsMin[i], boundsMax[i]);
+        grid.Insert(i, boundsMin[i], boundsMax[i]);
+    }
+
+    // Points each road is split at
+    std::vector<std::vector<glm::vec3>> splitPoints(roadCount);
+    std::vector<uint32_t> candidates;
+    unsigned int crossings = 0;
+    for (uint32_t i = 0; i < roadCount; i++)
+    {
+        grid.Query(boundsMin[i], boundsMax[i], candidates);
+        for (uint32_t j : candidates)
+        {
+            glm::vec3 point;
+            bool interiorI, interiorJ;
+            if (j <= i || !findCrossing(roadsVector[i], roadsVector[j], point, interiorI, interiorJ))
+                continue;
+
+            if (interiorI) { splitPoints[i].push_back(point); }
+            if (interiorJ) { splitPoints[j].push_back(point); }
+            crossings++;
+        }
+    }
+
+    std::vector<road_gen_road> split;
+    split.reserve(roadCount + crossings*2);
+    for (uint32_t i = 0; i < roadCount; i++)
+    {
+        const road_gen_road& road = roadsVector[i];
+        std::vector<glm::vec3>& points = splitPoints[i];
+        if (points.empty())
+        {
+            split.push_back(road);
+            continue;
+        }
+
+        // Pieces run from a to b, points closer than the weld tolerance are the same junction
+        std::sort(points.begin(), points.end(), [&](const glm::vec3& lhs, const glm::vec3& rhs)
+        {
+            return glm::length(lhs - road.a) < glm::length(rhs - road.a);
+        });
+        points.push_back(road.b);
+
+        glm::vec3 start = road.a;
+        for (const glm::vec3& end : points)
+        {
+            if (glm::length(end - start) <= roadWeldTolerance)
+                continue;
+
+            road_gen_road piece = road;
+            piece.a = start;
+            piece.b = end;
+            piece.UpdateLineProps();
+            split.push_back(piece);
+            start = end;
+        }
+    }
+
+    PROFILE_COUNTER("roads tested", roadCount);
+    PROFILE_COUNTER("crossings", crossings);
+    PROFILE_COUNTER("roads added", split.size() - roadCount);
+    roadsVector.swap(split);
+}
+
+
+std::atomic<CrossingPolicy> crossingPolicy{CrossingPolicy::REMOVE};
+
+void generator::SetCrossingPolicy(CrossingPolicy policy)
+{
+    crossingPolicy = policy;
+}
+
+
+CrossingPolicy generator::GetCrossingPolicy(void)
+{
+    return crossingPolicy;
+}
+
+
+// @brief Resolve roads that cross each other with the crossing policy
+// @args roadsVector - roads to resolve, updated by this method keeping the order of the roads
+// @args cellSize - grid cell size, the road length works well
+void resolveCrossings(std::vector<road_gen_road>& roadsVector, float cellSize)
+{
+    const size_t roadCount = roadsVector.size();
+    if (crossingPolicy == CrossingPolicy::SPLIT)
+    {
+        splitCrossingRoads(roadsVector, cellSize);
+        LOG(STATUS, "[" << roadsVector.size() - roadCount << "] roads added splitting crossing roads.");
+    }
+    else
+    {
+        cullIntersectingRoads(roadsVector, cellSize);
+        LOG(STATUS, "[" << roadCount - roadsVector.size() << "] roads removed due to intersections.");
+    }
+}
+
+
+// @brief Build the road graph of a city and log how its roads connect
+void buildRoadGraph(CityData* city)
+{
+    PROFILE_SCOPE("BuildRoadGraph");
+    BuildCityRoadGraph(city);
+
+    const RoadGraph& graph = city->graph;
+    unsigned int deadEnds = 0, junctions = 0;
+    for (uint32_t node = 0; node < graph.GetNodeCount(); node++)
+    {
+        const uint32_t degree = graph.GetDegree(node);
+        if (degree == 1) { deadEnds++; }
+        else if (degree >= 3) { junctions++; }
+    }
+    PROFILE_COUNTER("nodes", graph.GetNodeCount());
+    PROFILE_COUNTER("dead ends", deadEnds);
+    PROFILE_COUNTER("junctions", junctions);
+    LOG(STATUS, "Road graph: " << graph.GetNodeCount() << " nodes, " << graph.GetEdgeCount() << " edges, "
+        << deadEnds << " dead ends, " << junctions << " junctions");
+}
+
+
+// Main generation function
+CityData generator::GenerateCityData(unsigned int seed_in, const CityGenerationOverrides& overrides)
+{
+    PROFILE_SCOPE("GenerateCityData");
+    // Generate new city with a new seed, else use seed
+    unsigned int seed = (seed_in == 0) ? Random::GenerateSeed() : seed_in;
+    RandomStream random(seed, STREAM_CITY_PARAMETERS);
+
+    // First we need to determine how many smaller cities we are going to have
+    int numberOfCities = random.GetIntBetweenInclusive(1, 6);
+    float densityFactor = random.GetFloatBetweenInclusive(0.5f, 0.8f);    // The percentage probability of a building being placed
+    if (overrides.numberOfCities > 0) { numberOfCities = overrides.numberOfCities; }
+
+    std::vector<CityGenerationParameters> cityParameterVector;
+    std::vector<std::vector<road_gen_point>> cityEndNodesVector;
+    std::vector<road_gen_road> cityRoads;
+
+    // Then we need to know the parameters to give to each city:
+    for (int i = 0; i < numberOfCities; i++)
+    {
+        cityParameterVector.push_back({
+            glm::vec3{random.GetIntBetweenInclusive(-200, 200), 0, random.GetIntBetweenInclusive(-200, 200)},
+            random.GetFloatBetweenInclusive(0, 2*M_PI),    // Start angle in radians 
+            random.GetIntBetweenInclusive(2, 5),           // Iterations of grammar
+            random.GetFloatBetweenInclusive(3.0f, 5.0f),   // Road length
+            1.0f,                                           // Keep road width the same (1.0f)
+            random.GetFloatBetweenInclusive(5.0f, 7.0f),   // Lower connection threshold for new road connection
+            random.GetFloatBetweenInclusive(10.0f, 12.0f), // Upper connection threshold 
+            random.GetFloatBetweenInclusive(87.0f, 93.0f), // Angle between roads in degrees
+        });
+        if (overrides.iterations > 0) { cityParameterVector.back().iterations = overrides.iterations; }
+
+        // Vector initalizatio
+        std::vector<road_gen_point> cityVector;
+        cityEndNodesVector.push_back(cityVector);
+    }
+
+    LOG(STATUS, "Number of cities: " << numberOfCities);
+    for (int i = 0; i < numberOfCities; i++)
+    {
+        auto city = cityParameterVector[i];
+        LOG(STATUS, "\nCITY NUMBER " << i+1);
+        LOG(STATUS, "Start vector: " << city.startPosition);
+        LOG(STATUS, "Start angle: " << city.startAngle);
+        LOG(STATUS, "Iteration: " << city.iterations);
+        LOG(STATUS, "Length: " << city.roadLength);
+        LOG(STATUS, "Road width: " << city.roadWidth);
+        LOG(STATUS, "Road angle: " << city.roadAngleDegrees);
+    }
+
+
+    // Each city draws from its own stream so the cities can be generated in any order on any thread
+    std::vector<std::vector<road_gen_road>> roadsPerCity(cityParameterVector.size());
+    ThreadPool::getInstance()->ParallelFor(cityParameterVector.size(), [&](size_t i)
+    {
+        // Generate and get all end nodes
+        auto city = cityParameterVector[i];
+        RandomStream cityRandom(seed, STREAM_CITY_ROADS + i);
+        roadsPerCity[i] = GenerateRoads(city.startPosition, city.startAngle, city.iterations, city.roadLength, city.roadWidth, city.roadAngleDegrees, &cityEndNodesVector[i], cityRandom);
+    });
+
+    // Merge in city order, then remove roads of overlapping cities that cross each other.
+    // Cities used to be culled one after the other against every road generated before them, where
+    // overlapping cities cross that picks different roads to remove, so some seeds (7 for one) lay out
+    // differently from builds before parallel generation. The order here is the one kept from now on
+    float maxRoadLength = 0.0f;
+    for (size_t i = 0; i < cityParameterVector.size(); i++)
+    {
+        cityRoads.insert(cityRoads.end(), roadsPerCity[i].begin(), roadsPerCity[i].end());
+        maxRoadLength = glm::max(maxRoadLength, cityParameterVector[i].roadLength);
+    }
+    resolveCrossings(cityRoads, maxRoadLength);
+
+    createHighways(&cityRoads, &cityEndNodesVector, 50.0f, 500.0f, 1.0f);
+
+
+    for (size_t i = 0; i < cityParameterVector.size(); i++)
+    {
+        // Create the new roads between end nodes 
+        createNewRoads(&cityRoads, 
+                &cityEndNodesVector[i], 
+                cityParameterVector[i].roadWidth, 
+                cityParameterVector[i].roadLength, 
+                cityParameterVector[i].lowerConnectionThreshold, 
+                cityParameterVector[i].upperConnectionThreshold);
+    }
+   
+    // Pass of removeDupes
+    removeDupes(&cityRoads);
+    
+
+    CityData city;
+    city.seed = seed;
+    city.densityFactor = densityFactor;
+
+    LOG(STATUS, "Number of roads generated: " << cityRoads.size())
+
+    // Build the zones for each road, the scene does the same when the roads are added
+    {
+        PROFILE_SCOPE("CreateCityRoads");
+        city.roads.reserve(cityRoads.size());
+        for (auto& road : cityRoads)
+        {
+            CityRoad cityRoad = CreateCityRoad(road.a, road.b, road.width);
+            cityRoad.allowBuildingZones = road.allowBuildingZones;
+            cityRoad.createTrees = road.createTrees;
+            if (!road.allowBuildingZones)
+            {
+                cityRoad.zoneA.usable = false;
+                cityRoad.zoneB.usable = false;
+            }
+            city.roads.push_back(cityRoad);
+        }
+    }
+    buildRoadGraph(&city);
+
+    // Add trees
+    GenerateTrees(&city);
+
+    // Needed to avoid overlapping
+    CalculateValidZones(&city); // costly but needed
+    GenerateBuildings(&city);
+
+    return city;
+}
+
+
+// Most towns a chunk can have
+constexpr int maxTownsPerChunk = 2;
+// Town roads further than this from the town start are dropped, so a town never reaches further than its neighbouring chunks
+constexpr float townRadius = chunkSize * 0.4f;
+// Roads this close to a chunk are generated with it so the zones on its border see the roads of its neighbours.
+// Covers half the longest end node connection plus its zone
+constexpr float chunkContextMargin = 40.0f;
+
+// A town of a chunk, only its parameters so the towns of far chunks are cheap to look at
+struct ChunkTown
+{
+    ChunkCoord chunk;
+    int index; // Within its chunk
+    CityGenerationParameters parameters;
+};
+
+// @brief Towns of a chunk, from the chunks own parameter stream
+std::vector<ChunkTown> getChunkTowns(unsigned int seed, ChunkCoord chunk)
+{
+    RandomStream random(Random::MakeChunkSeed(seed, chunk.x, chunk.z), STREAM_CITY_PARAMETERS);
+    const glm::vec2 chunkMin = GetChunkMin(chunk);
+
+    std::vector<ChunkTown> towns(random.GetIntBetweenInclusive(0, maxTownsPerChunk));
+    for (size_t i = 0; i < towns.size(); i++)
+    {
+        const float x = chunkMin.x + random.GetFloatBetweenInclusive(0.0f, chunkSize);
+        const float z = chunkMin.y + random.GetFloatBetweenInclusive(0.0f, chunkSize);
+        towns[i] = {chunk, static_cast<int>(i), {
+            glm::vec3{x, 0, z},
+            random.GetFloatBetweenInclusive(0, 2*M_PI),    // Start angle in radians
+            random.GetIntBetweenInclusive(2, 4),           // Iterations of grammar, towns are cut at townRadius anyway
+            random.GetFloatBetweenInclusive(3.0f, 5.0f),   // Road length
+            1.0f,                                           // Keep road width the same (1.0f)
+            random.GetFloatBetweenInclusive(5.0f, 7.0f),   // Lower connection threshold for new road connection
+            random.GetFloatBetweenInclusive(10.0f, 12.0f), // Upper connection threshold
+            random.GetFloatBetweenInclusive(87.0f, 93.0f), // Angle between roads in degrees
+        }};
+    }
+    return towns;
+}
+
+// @brief Roads of one town, the same passes GenerateCityData runs on a city but only over the towns own roads
+std::vector<road_gen_road> generateTownRoads(unsigned int seed, const ChunkTown& town)
+{
+    const CityGenerationParameters& city = town.parameters;
+    RandomStream townRandom(Random::MakeChunkSeed(seed, town.chunk.x, town.chunk.z), STREAM_CITY_ROADS + town.index);
+
+    std::vector<road_gen_point> endNodes;
+    std::vector<road_gen_road> roads = generator::GenerateRoads(city.startPosition, city.startAngle, city.iterations, city.roadLength, city.roadWidth, city.roadAngleDegrees, &endNodes, townRandom);
+
+    // Keep the town inside its radius
+    auto outsideTown = [&](const glm::vec3& point)
+    {
+        return glm::length(glm::vec2{point.x - city.startPosition.x, point.z - city.startPosition.z}) > townRadius;
+    };
+    roads.erase(std::remove_if(roads.begin(), roads.end(), [&](const road_gen_road& road)
+    {
+        return outsideTown(road.a) || outsideTown(road.b);
+    }), roads.end());
+    endNodes.erase(std::remove_if(endNodes.begin(), endNodes.end(), [&](const road_gen_point& node)
+    {
+        return outsideTown(node.point);
+    }), endNodes.end());
+
+    resolveCrossings(roads, city.roadLength);
+    createNewRoads(&roads, &endNodes, city.roadWidth, city.roadLength, city.lowerConnectionThreshold, city.upperConnectionThreshold);
+    removeDupes(&roads);
+    return roads;
+}
+
+// @brief Part of the segment a-b inside the xz rectangle min-max (Liang-Barsky)
+// Both chunks either side of a border compute the same point on it
+// @returns false if the segment misses the rectangle
+bool clipSegmentXZ(const glm::vec3& a, const glm::vec3& b, glm::vec2 min, glm::vec2 max, glm::vec3& outA, glm::vec3& outB)
+{
+    const glm::vec3 direction = b - a;
+    const float p[4] = {-direction.x, direction.x, -direction.z, direction.z};
+    const float q[4] = {a.x - min.x, max.x - a.x, a.z - min.y, max.y - a.z};
+
+    float tEnter = 0.0f, tLeave = 1.0f;
+    for (int i = 0; i < 4; i++)
+    {
+        if (p[i] == 0.0f)
+        {
+            // Parallel to this edge and outside of it
+            if (q[i] < 0.0f)
+                return false;
+            continue;
+        }
+        const float t = q[i] / p[i];
+        if (p[i] < 0.0f)
+            tEnter = glm::max(tEnter, t);
+        else
+            tLeave = glm::min(tLeave, t);
+    }
+    if (tEnter >= tLeave)
+        return false;
+
+    outA = (tEnter == 0.0f) ? a : a + direction * tEnter;
+    outB = (tLeave == 1.0f) ? b : a + direction * tLeave;
+    return true;
+}
+
+
+CityData generator::GenerateChunkData(unsigned int seed, ChunkCoord chunk)
+{
+    PROFILE_SCOPE("GenerateChunkData");
+    LOG(STATUS, "[ Started GenerateChunk " << chunk.x << ", " << chunk.z << " ]");
+    auto chunkGenerateStartTime = StopWatch::GetCurrentTimePoint();
+
+    const glm::vec2 chunkMin = GetChunkMin(chunk);
+    const glm::vec2 chunkMax = GetChunkMax(chunk);
+    const glm::vec2 contextMin = chunkMin - glm::vec2(chunkContextMargin);
+    const glm::vec2 contextMax = chunkMax + glm::vec2(chunkContextMargin);
+
+    // Towns of the 5x5 chunks around this one, highways between them can reach the 3x3 around this one.
+    // Towns are in (x, z, index) order, earlier towns win where roads of two towns cross
+    std::vector<std::vector<ChunkTown>> chunkTowns;
+    auto getTowns = [&](int dx, int dz) -> std::vector<ChunkTown>& { return chunkTowns[(dx + 2) * 5 + (dz + 2)]; };
+    for (int dx = -2; dx <= 2; dx++)
+    {
+        for (int dz = -2; dz <= 2; dz++)
+        {
+            chunkTowns.push_back(getChunkTowns(seed, {chunk.x + dx, chunk.z + dz}));
+        }
+    }
+
+    // Highways join the first towns of neighbouring chunks, from a chunk to the next one along x and along z
+    std::vector<road_gen_road> highways;
+    for (int dx = -2; dx <= 2; dx++)
+    {
+        for (int dz = -2; dz <= 2; dz++)
+        {
+            if (getTowns(dx, dz).empty())
+                continue;
+            const glm::vec3 start = getTowns(dx, dz)[0].parameters.startPosition;
+            if (dx < 2 && !getTowns(dx+1, dz).empty())
+            {
+                highways.push_back({start, getTowns(dx+1, dz)[0].parameters.startPosition, 1.5f});
+            }
+            if (dz < 2 && !getTowns(dx, dz+1).empty())
+            {
+                highways.push_back({start, getTowns(dx, dz+1)[0].parameters.startPosition, 1.5f});
+            }
+        }
+    }
+
+    // Roads of every town of the 5x5. Only roads in this chunk or its context are kept, but whether one of
+    // them is crossed by an earlier town has to be answered against the same towns by every chunk that
+    // generates it, and a road on the edge of the 3x3 can be reached by towns further out
+    std::vector<ChunkTown> nearTowns;
+    for (const auto& towns : chunkTowns)
+    {
+        nearTowns.insert(nearTowns.end(), towns.begin(), towns.end());
+    }
+    std::vector<std::vector<road_gen_road>> townRoads(nearTowns.size());
+    ThreadPool::getInstance()->ParallelFor(nearTowns.size(), [&](size_t t)
+    {
+        townRoads[t] = generateTownRoads(seed, nearTowns[t]);
+    });
+
+    // Every town road in one grid to find crossings between towns
+    std::vector<road_gen_road> allRoads;
+    std::vector<uint32_t> roadTown;
+    for (size_t t = 0; t < townRoads.size(); t++)
+    {
+        allRoads.insert(allRoads.end(), townRoads[t].begin(), townRoads[t].end());
+        roadTown.insert(roadTown.end(), townRoads[t].size(), t);
+    }
+    SpatialGrid roadGrid(chunkContextMargin);
+    std::vector<glm::vec2> boundsMin(allRoads.size()), boundsMax(allRoads.size());
+    for (uint32_t r = 0; r < allRoads.size(); r++)
+    {
+        GetSegmentBoundsXZ(allRoads[r].a, allRoads[r].b, intersectionGridPadding, boundsMin[r], boundsMax[r]);
+        roadGrid.Insert(r, boundsMin[r], boundsMax[r]);
+    }
+
+    // A town road is kept if it is in this chunk or its context, and crosses no highway and no road of an
+    // earlier town. Only pairs are looked at, never what else was removed, so a road gets the same answer
+    // from every chunk that generates it
+    std::vector<road_gen_road> ownedRoads, contextRoads;
+    std::vector<uint32_t> nearby;
+    for (uint32_t r = 0; r < allRoads.size(); r++)
+    {
+        const road_gen_road& road = allRoads[r];
+        if (boundsMax[r].x < contextMin.x || boundsMin[r].x > contextMax.x ||
+            boundsMax[r].y < contextMin.y || boundsMin[r].y > contextMax.y)
+            continue;
+
+        bool crosses = false;
+        for (auto& highway : highways)
+        {
+            if (allRoads[r].isInterceptingAndNodes(highway))
+            {
+                crosses = true;
+                break;
+            }
+        }
+        roadGrid.Query(boundsMin[r], boundsMax[r], nearby);
+        for (size_t n = 0; n < nearby.size() && !crosses; n++)
+        {
+            const uint32_t other = nearby[n];
+            crosses = roadTown[other] < roadTown[r] && allRoads[r].isInterceptingAndNodes(allRoads[other]);
+        }
+        if (crosses)
+            continue;
+
+        // The chunk the middle of the road is in owns it
+        const glm::vec3 middle = road.a + (road.b - road.a) * 0.5f;
+        if (GetChunkCoord(middle) == chunk)
+            ownedRoads.push_back(road);
+        else
+            contextRoads.push_back(road);
+    }
+
+    // Highways are cut at the chunk borders, each chunk owns the part inside it
+    for (auto& highway : highways)
+    {
+        for (int dx = -1; dx <= 1; dx++)
+        {
+            for (int dz = -1; dz <= 1; dz++)
+            {
+                const ChunkCoord piece = {chunk.x + dx, chunk.z + dz};
+                road_gen_road highwayPiece = highway;
+                if (!clipSegmentXZ(highway.a, highway.b, GetChunkMin(piece), GetChunkMax(piece), highwayPiece.a, highwayPiece.b))
+                    continue;
+                highwayPiece.allowBuildingZones = false;
+                highwayPiece.createTrees = true;
+
+                glm::vec2 pieceMin, pieceMax;
+                GetSegmentBoundsXZ(highwayPiece.a, highwayPiece.b, 0.0f, pieceMin, pieceMax);
+                if (piece == chunk)
+                    ownedRoads.push_back(highwayPiece);
+                else if (pieceMax.x >= contextMin.x && pieceMin.x <= contextMax.x &&
+                         pieceMax.y >= contextMin.y && pieceMin.y <= contextMax.y)
+                    contextRoads.push_back(highwayPiece);
+            }
+        }
+    }
+
+    // Same density as the city GenerateCityData makes for this seed
+    RandomStream random(seed, STREAM_CITY_PARAMETERS);
+    random.GetIntBetweenInclusive(1, 6);
+
+    CityData city;
+    city.seed = Random::MakeChunkSeed(seed, chunk.x, chunk.z);
+    city.densityFactor = random.GetFloatBetweenInclusive(0.5f, 0.8f);
+
+    // Zones are worked out with the context roads, then only the roads of this chunk are kept
+    const size_t ownedCount = ownedRoads.size();
+    ownedRoads.insert(ownedRoads.end(), contextRoads.begin(), contextRoads.end());
+    city.roads.reserve(ownedRoads.size());
+    for (auto& road : ownedRoads)
+    {
+        CityRoad cityRoad = CreateCityRoad(road.a, road.b, road.width);
+        cityRoad.allowBuildingZones = road.allowBuildingZones;
+        cityRoad.createTrees = road.createTrees;
+        if (!road.allowBuildingZones)
+        {
+            cityRoad.zoneA.usable = false;
+            cityRoad.zoneB.usable = false;
+        }
+        city.roads.push_back(cityRoad);
+    }
+    CalculateValidZones(&city);
+    city.roads.resize(ownedCount);
+    buildRoadGraph(&city);
+
+    // Buildings stay inside the chunk so they cannot overlap the buildings of a neighbour
+    auto outsideChunk = [&](const glm::vec3& point)
+    {
+        return point.x < chunkMin.x || point.x >= chunkMax.x || point.z < chunkMin.y || point.z >= chunkMax.y;
+    };
+    for (auto& road : city.roads)
+    {
+        for (CityZone* zone : {&road.zoneA, &road.zoneB})
+        {
+            for (auto& area : zone->areas)
+            {
+                area.isOccupied = std::any_of(area.zoneVerticesArray.begin(), area.zoneVerticesArray.end(), outsideChunk);
+            }
+        }
+    }
+
+    GenerateTrees(&city);
+    GenerateBuildings(&city);
+
+    uint64_t timeElapsed = StopWatch::GetTimeElapsed(chunkGenerateStartTime);
+    LOG(STATUS, "[ GenerateChunk finished. " << city.roads.size() << " roads, " << city.buildings.size() << " buildings. Time elapsed: " << timeElapsed << "ms ]\n");
+    return city;
+}
+
+
+// Our grammars, compiled into their rule tables at compile time
+constexpr auto treeGrammar = lsystem::Compile<32>("axiom: X; X -> F[+X]F[-X]F[-X]F[+X]F; F -> FF"); // GOOD
+static_assert(treeGrammar.error == nullptr, "Built in grammar failed to compile");
+// constexpr auto runesGrammar = lsystem::Compile<32>("axiom: X; X -> X[+X][-X]XX"); // DOOM RUNES (COOL)
+
+// Grammars loaded with generator::LoadGrammar, picked from along with the built in ones
+std::vector<lsystem::Grammar> userGrammars;
+
+// Grammar indices below this are the built in grammars, the user grammars follow them
+constexpr int builtInGrammarCount = 1;
+
+// Randomly select a grammar
+lsystem::GrammarView pickGrammar(RandomStream& random)
+{
+    const int grammarCount = builtInGrammarCount + static_cast<int>(userGrammars.size());
+    int grammarIndex = random.GetIntBetweenInclusive(0, grammarCount - 1);
+    LOG(WARN, "GRAMMAR: " << grammarIndex << " chosen");
+    if (grammarIndex < builtInGrammarCount)
+    {
+        return treeGrammar.View();
+    }
+    return userGrammars[grammarIndex - builtInGrammarCount].View();
+}
+
+// End nodes are the same if their point and heading match
+struct EndNodeHash
+{
+    size_t operator()(const road_gen_point& node) const
+    {
+        size_t hash = std::hash<float>()(node.point.x);
+        hash = hash * 31 + std::hash<float>()(node.point.y);
+        hash = hash * 31 + std::hash<float>()(node.point.z);
+        return hash * 31 + std::hash<float>()(node.degreeHeading);
+    }
+};
+
+struct EndNodeEqual
+{
+    bool operator()(const road_gen_point& a, const road_gen_point& b) const
+    {
+        return (a.point == b.point) && (a.degreeHeading == b.degreeHeading);
+    }
+};
+
+
+std::vector<road_gen_road> generator::GenerateRoads(glm::vec3 startPos,
+                                                    float startAngle,
+                                                    int iterations,
+                                                    float roadLength, 
+                                                    float roadWidth, 
+                                                    float roadAngleDegrees,
+                                                    std::vector<road_gen_point>* endNodes,
+                                                    RandomStream& random)
+{
+    PROFILE_SCOPE("GenerateRoads");
+    auto roadGenerateStartTime = StopWatch::GetCurrentTimePoint();
+
+    // Warning as this will cause z-fighting
+    if (roadWidth >= roadLength)
+    {
+        LOG(WARN_SERV(LOG_GEN), "RoadLength is less than or equal to roadWidth. This can cause Z-fighting.")
+    }
+
+    LOG(STATUS, "[ Starting GenerateRoads ]");
+
+    // Output for current settings for the road generation
+    LOG(STATUS, "==== Generation settings ====");
+    LOG(STATUS, "||\tIterations:\t" << iterations);
+    LOG(STATUS, "||\tRoadLength:\t" << roadLength);
+    LOG(STATUS, "||\tRoadWidth: \t" << roadWidth);
+    LOG(STATUS, "||\tRoadAngle: \t" << roadAngleDegrees << " (degrees)");
+    LOG(STATUS, "==== Generation settings ====");
+
+
+    // grammar
+    // Pick a random grammar, the expanded string is never built. Symbols are streamed into the turtle below
+    const lsystem::GrammarView grammar = pickGrammar(random);
+
+    std::stack<road_gen_point> pointStack;
+
+    // End nodes from roads that are delted later will still be here, not an issue for the final product
+
+    // Test point
+    // glm::vec3 startPoint = {0.0, 0.0, 0.0};
+    road_gen_point currentPoint = {startPos, startAngle}; // Heading of 0 radians
+        
+    float degreeRadians = roadAngleDegrees * (M_PI/180);
+   
+
+    std::vector<road_gen_road> roadsVector;
+
+
+    // Key:
+    // 
+    // F[-X]
+    // F Foward n units
+    // - Left n degrees
+    // + Right n degrees
+    // X Forward (end node)
+    // [ Push point to stack
+    // ] Pop point to stack
+    // A parameter scales the move or turn, F(2) goes forward 2n units, +(0.5) turns right n/2 degrees
+
+    // Check end nodes by point and heading without searching all of them
+    std::unordered_set<road_gen_point, EndNodeHash, EndNodeEqual> endNodeSet;
+    endNodeSet.insert(endNodes->begin(), endNodes->end());
+
+    lsystem::Expand(grammar, iterations, random, [&](char symbol, float parameter)
+    {
+        switch (symbol)
+        {
+        case 'F':
+        {
+            // Go forward relative to its angle
+            glm::vec3 nextPoint = {
+                currentPoint.point.x + ((roadLength * parameter) * glm::sin(currentPoint.degreeHeading)),
+                currentPoint.point.y,
+                currentPoint.point.z + ((roadLength * parameter) * glm::cos(currentPoint.degreeHeading))
+            };
+
+            roadsVector.push_back({currentPoint.point, nextPoint, roadWidth}); // Add to our local road vector before adding to the scene
+            currentPoint.point = nextPoint; // Update current point, no change to bearing
+            
+            break;
+        }
+        case 'X':
+        {
+            // Go forward relative to its angle
+            glm::vec3 nextPoint = {
+                currentPoint.point.x + ((roadLength * parameter) * glm::sin(currentPoint.degreeHeading)),
+                currentPoint.point.y,
+                currentPoint.point.z + ((roadLength * parameter) * glm::cos(currentPoint.degreeHeading))
+            };
+            
+            roadsVector.push_back({currentPoint.point, nextPoint, roadWidth}); // ^^
+
+            // If the end point is in the vector already we wont add.
+            // The set is only for the lookup, the vector is kept as later on we need to access the values and attributes
+            road_gen_point endNode = {nextPoint, currentPoint.degreeHeading};
+            if (endNodeSet.insert(endNode).second)
+            {
+                endNodes->push_back(endNode);
+            }
+
+            currentPoint.point = nextPoint; // Update current point, no change to bearing
+            
+            break;
+        }
+        case '-':
+        {
+            currentPoint.degreeHeading += degreeRadians * parameter;
+            // Turn left n degrees
+            break;
+        }
+        case '+':
+        {
+            currentPoint.degreeHeading -= degreeRadians * parameter;
+            // Turn right n degrees
+            break;
+        }
+        case '[':
+        {
+            pointStack.push(currentPoint);
+            // Push point to stack
+            break;
+        }
+        case ']':
+        {
+            // Compiled grammars balance their brackets, an unmatched ] is skipped rather than popping an empty stack
+            if (pointStack.empty())
+            {
+                LOG(WARN_SERV(LOG_GEN), "Unmatched ] in GenerateRoads(), skipped");
+                break;
+            }
+            currentPoint = pointStack.top(); // Read
+            pointStack.pop(); // pop
+            // Pop point from stack
+            break;
+        }
+        default:
+        {
+            LOG(WARN, "Default taken on switch in GenerateRoads()")
+            break;
+        }
+        } // switch(symbol)
+    });
+
+    // Pass vector as pointer
+    // removeDupes(&roadsVector);
+
+    // For all the remaining roads we now have to calculate their line properties to determine if they intersect
+    for (auto& road : roadsVector)
+    {
+        road.UpdateLineProps();
+    }
+
+    
+    resolveCrossings(roadsVector, roadLength);
+
+
+    // Create highways before new mini roads
+    // When generating, we could give a radius from 0,0 for roads to be permitted, this would give a good effect IMO
+    PROFILE_COUNTER("roads", roadsVector.size());
+    uint64_t timeElapsed = StopWatch::GetTimeElapsed(roadGenerateStartTime);
+    LOG(STATUS, "[ GenerateRoads finished. Time elapsed: " << timeElapsed << "ms ]\n");
+
+
+    return roadsVector;
+}
+
+uint64_t generator::GetGenerationKey(unsigned int seed, const CityGenerationOverrides& overrides)
+{
+    uint64_t key = 14695981039346656037ull; // FNV-1a
+    auto add = [&key](const auto& value)
+    {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+        for (size_t i = 0; i < sizeof(value); i++)
+        {
+            key ^= bytes[i];
+            key *= 1099511628211ull;
+        }
+    };
+
+    add(generatorVersion);
+    add(seed);
+    add(overrides.numberOfCities);
+    add(overrides.iterations);
+    add(static_cast<uint32_t>(GetCrossingPolicy()));
+
+    // Field by field, the structs have padding
+    for (const lsystem::Grammar& grammar : userGrammars)
+    {
+        for (const lsystem::Symbol& symbol : grammar.symbols)
+        {
+            add(symbol.symbol); add(symbol.parameter.scale); add(symbol.parameter.offset);
+        }
+        for (const lsystem::Production& production : grammar.productions)
+        {
+            add(production.predecessor); add(production.first); add(production.count); add(production.weight);
+        }
+        add(grammar.axiomFirst);
+        add(grammar.axiomCount);
+    }
+    return key;
+}
+
+
+bool generator::LoadGrammar(const std::string& path)
+{
+    lsystem::Grammar grammar;
+    if (!grammar.LoadFile(path))
+    {
+        return false;
+    }
+    userGrammars.push_back(std::move(grammar));
+    LOG(STATUS_SERV(LOG_GEN), "Loaded grammar " << path);
+    return true;
+}
+
+
+void generator::LSystemGen(std::string *axiom, uint iterations, RandomStream& random)
+{
+    if (*axiom == "")
+    {
+        LOG(WARN, "Axiom is empty, nothing will be generated");
+        return;
+    }
+
+    const lsystem::GrammarView grammar = pickGrammar(random);
+
+    std::vector<lsystem::Symbol> axiomSymbols;
+    for (char symbol : *axiom)
+    {
+        axiomSymbols.push_back({symbol, {}});
+    }
+
+    std::string expanded;
+    lsystem::Expand(grammar, axiomSymbols.data(), axiomSymbols.data() + axiomSymbols.size(), iterations, random, [&](char symbol, float)
+    {
+        expanded.push_back(symbol);
+    });
+    *axiom = expanded;
+}
+
+// Extra room on the broad phase bounds so float error can never drop a pair the circle test would keep
+constexpr float zoneBroadPhasePadding = 0.1f;
+
+void generator::CalculateValidZones(CityData* city)
+{
+    
+    LOG(STATUS, "[ Started GenerateValidZones ]");
+    PROFILE_SCOPE("CalculateValidZones");
+    auto generateValidZonesStartTime = StopWatch::GetCurrentTimePoint();
+
+    // Determine the zones either side of the roads
+    std::vector<CityRoad>& roads = city->roads;
+
+    // Road OBBs and bounding circles are precomputed once, the SAT boxes into the SoA store for the batched SAT
+    SATBoxStore roadBoxes;
+    roadBoxes.Reserve(roads.size());
+    std::vector<BoundingCircle> circles(roads.size());
+    std::vector<glm::vec2> boundsMin(roads.size()), boundsMax(roads.size());
+    for (size_t i = 0; i < roads.size(); i++)
+    {
+        roadBoxes.Add(MakeSATBox(roads[i].geometry.obb));
+        circles[i] = CalculateBoundingCircle(roads[i].geometry.obb);
+
+        // Square around the circle, padded so the circle test below is the only one that decides
+        const float extent = circles[i].radius + zoneCollisionThreshold/2 + zoneBroadPhasePadding;
+        boundsMin[i] = {circles[i].center.x - extent, circles[i].center.z - extent};
+        boundsMax[i] = {circles[i].center.x + extent, circles[i].center.z + extent};
+    }
+
+    // Broad phase, candidate pairs found once rather than testing every road against every road
+    BroadPhasePairs pairs;
+    SweepAndPrune(boundsMin, boundsMax, pairs);
+
+    // Each road only writes its own zones and count, so roads can be tested in parallel
+    std::vector<unsigned int> roadCollisionCounts(roads.size(), 0);
+    ThreadPool::getInstance()->ParallelFor(roads.size(), [&](size_t i)
+    {
+        // Optimization cull those which are too far away to be considered.
+        // One list per worker thread, kept between roads so it is not allocated for each of them
+        static thread_local std::vector<uint32_t> candidates;
+        candidates.clear();
+        for (uint32_t p = pairs.offsets[i]; p < pairs.offsets[i+1]; p++)
+        {
+            const uint32_t j = pairs.neighbours[p];
+            if (!TooFarForCollision(circles[i], circles[j], zoneCollisionThreshold))
+            {
+                candidates.push_back(j);
+            }
+        }
+
+        const SATBox zoneA = MakeSATBox(roads[i].zoneA.vertices);
+        const SATBox zoneB = MakeSATBox(roads[i].zoneB.vertices);
+        bool zoneACollide = false;
+        bool zoneBCollide = false;
+        SATBoxBlock block;
+
+        // Test the candidates 8 at a time, then count them in order so the count stops where it always has
+        for (size_t first = 0; first < candidates.size() && !(zoneACollide && zoneBCollide); first += SATBoxBlock::lanes)
+        {
+            const int laneCount = std::min<size_t>(SATBoxBlock::lanes, candidates.size() - first);
+            roadBoxes.Gather(&candidates[first], laneCount, block);
+            const uint32_t hitsA = IntersectsSATBatch(zoneA, block, laneCount);
+            const uint32_t hitsB = IntersectsSATBatch(zoneB, block, laneCount);
+
+            for (int l = 0; l < laneCount; l++)
+            {
+                if (hitsA & (1u << l))
+                {
+                    roads[i].zoneA.usable = false;
+                    roadCollisionCounts[i]++;
+                    zoneACollide = true;
+                }
+                if (hitsB & (1u << l))
+                {
+                    roads[i].zoneB.usable = false;
+                    roadCollisionCounts[i]++;
+                    zoneBCollide = true;
+                }
+                // If both already collide we can skip onto the next i road
+                if (zoneACollide && zoneBCollide)
+                {
+                    break;
+                }
+            }
+        }
+    });
+
+    unsigned int collisionZoneCount = 0;
+    for (unsigned int count : roadCollisionCounts)
+    {
+        collisionZoneCount += count;
+    }
+
+    float percent = static_cast<float>(collisionZoneCount)/(roads.size()*2)*100;
+
+    LOG(STATUS, "Zones that collided: " << collisionZoneCount << "/" << roads.size()*2 << " (" << percent << "%)");
+    PROFILE_COUNTER("roads tested", roads.size());
+    PROFILE_COUNTER("broad phase pairs", pairs.GetPairCount());
+    PROFILE_COUNTER("zones collided", collisionZoneCount);
+
+    uint64_t timeElapsed = StopWatch::GetTimeElapsed(generateValidZonesStartTime);
+    LOG(STATUS, "[ GenerateAssets finished. Time elapsed: " << timeElapsed << "ms ]\n");
+}
+
+#define MAXLOOPS 100
+
+void generator::SelectBuildingAreas(CityData* city, size_t roadIndex, bool isZoneB, std::vector<uint32_t>& areaIndices)
+{
+    areaIndices.clear();
+    CityZone& zone = isZoneB ? city->roads[roadIndex].zoneB : city->roads[roadIndex].zoneA;
+
+    // One draw per area, each zone has its own range of the stream
+    RandomStream random(city->seed, STREAM_BUILDINGS, zoneStreamIndex(roadIndex, isZoneB));
+    float percentages[MAXLOOPS];
+    random.FillPercentages(percentages, MAXLOOPS);
+
+    for (int i = 0; i < MAXLOOPS; i++)
+    {
+        auto area = zone.GetValidPlacement();
+
+        // Check we still have zones left
+        if (area == nullptr)
+            break;
+
+        // If we fall in range of the density factor we add the area for buildings to be placed
+        if (isZoneB ? (percentages[i] < city->densityFactor) : (percentages[i] <= city->densityFactor))
+        {
+            areaIndices.push_back(area - zone.areas.data());
+        }
+    }
+}
+
+
+unsigned int generator::GetBuildingModelIndex(size_t roadIndex, bool isZoneB, uint32_t areaIndex)
+{
+    // Neighbouring areas and the two sides of a road get different models
+    return (roadIndex * 7 + areaIndex + (isZoneB ? 4 : 0)) % paths::buildingModelPaths.size();
+}
+
+
+void generator::SelectTreeAreas(const CityData& city, size_t roadIndex, bool isZoneB, std::vector<uint32_t>& areaIndices)
+{
+    areaIndices.clear();
+    const CityZone& zone = isZoneB ? city.roads[roadIndex].zoneB : city.roads[roadIndex].zoneA;
+
+    // Get the areas for tree placement, one draw per area from the zones own range
+    std::vector<float> percentages(zone.areas.size());
+    RandomStream random(city.seed, STREAM_TREES, zoneStreamIndex(roadIndex, isZoneB));
+    random.FillPercentages(percentages.data(), percentages.size());
+    for (size_t i = 0; i < zone.areas.size(); i++)
+    {
+        if (percentages[i]+0.2 < city.densityFactor)
+        {
+            areaIndices.push_back(i);
+        }
+    }
+}
+
+
+void generator::GenerateBuildings(CityData* city)
+{
+    LOG(STATUS, "[ Started GeneratedBuildings ]");
+    PROFILE_SCOPE("GenerateBuildings");
+    auto buildingGenerateStartTime = StopWatch::GetCurrentTimePoint();
+
+    std::vector<CityRoad>& roads = city->roads;
+
+    std::vector<PlacementArea> areas;
+    std::vector<unsigned int> areaModels;   // Model of the building of each area
+    std::vector<uint32_t> areaIndices;
+
+    // All the zone A areas then all the zone B areas, later areas win where two overlap
+    for (bool isZoneB : {false, true})
+    {
+        for (size_t r = 0; r < roads.size(); r++)
+        {
+            CityZone& zone = isZoneB ? roads[r].zoneB : roads[r].zoneA;
+            if (!zone.usable)
+                continue;
+
+            SelectBuildingAreas(city, r, isZoneB, areaIndices);
+            for (uint32_t i : areaIndices)
+            {
+                areas.push_back(zone.areas[i]);
+                areaModels.push_back(GetBuildingModelIndex(r, isZoneB, i));
+            }
+        }
+    }
+    const int buildingCount = areas.size();
+    LOG(STATUS, "[" << buildingCount << "] Buildings generated."); 
+ 
+    // Pass to remove overlapping buildings
+    // An area is removed if it intersects any later area. Areas are binned by position so only
+    // areas within the detection range are tested, and each area only decides its own fate so
+    // they can be tested in parallel with the same buildings surviving
+    SpatialGrid areaGrid(buildingCollisionThresholdDetection);
+    for (size_t i = 0; i < areas.size(); i++)
+    {
+        const glm::vec2 position = {areas[i].position.x, areas[i].position.z};
+        areaGrid.Insert(i, position, position);
+    }
+
+    std::vector<uint8_t> areaIntersects(areas.size(), 0);
+    ThreadPool::getInstance()->ParallelFor(areas.size(), [&](size_t i)
+    {
+        // One list per worker thread, Query clears it for each area
+        static thread_local std::vector<uint32_t> nearby;
+        const glm::vec2 position = {areas[i].position.x, areas[i].position.z};
+        const glm::vec2 range = glm::vec2(buildingCollisionThresholdDetection);
+        areaGrid.Query(position - range, position + range, nearby);
+
+        for (uint32_t j : nearby)
+        {
+            if (j <= i || areas[i].TooFarForCollision(&areas[j]))
+            {
+                // Move onto next one
+                continue;
+            }
+            if (areas[i].Intersects(areas[j].zoneVerticesArray))
+            {
+                areaIntersects[i] = 1;
+                break;
+            }
+        }
+    });
+
+    int intersectingBuildings = 0;
+    for (size_t i = 0; i < areas.size(); i++)
+    {
+        if (!areaIntersects[i])
+        {
+            // Add random buildings
+            city->buildings.push_back(CreateCityBuilding(areas[i], areaModels[i]));
+        }
+        else {
+            intersectingBuildings++;
+        }
+    }
+    LOG(STATUS, "[" << intersectingBuildings << "] buildings removed. (" << static_cast<float>(intersectingBuildings)/static_cast<float>(buildingCount) * 100 << "%)");
+    PROFILE_COUNTER("lots tested", buildingCount);
+    PROFILE_COUNTER("lots placed", buildingCount - intersectingBuildings);
+
+    uint64_t timeElapsed = StopWatch::GetTimeElapsed(buildingGenerateStartTime);
+    LOG(STATUS, "[ GenerateBuildings finished. Time elapsed: " << timeElapsed << "ms ]\n");
+
+}
+
+void generator::GenerateTrees(CityData* city)
+{
+    PROFILE_SCOPE("GenerateTrees");
+    std::vector<uint32_t> areaIndices;
+
+    for (size_t r = 0; r < city->roads.size(); r++)
+    {
+        const CityRoad& road = city->roads[r];
+        if (!road.createTrees)
+            continue;
+
+        for (bool isZoneB : {false, true})
+        {
+            SelectTreeAreas(*city, r, isZoneB, areaIndices);
+            const CityZone& zone = isZoneB ? road.zoneB : road.zoneA;
+            for (uint32_t i : areaIndices)
+            {
+                city->trees.push_back({zone.areas[i].position});
+            }
+        }
+    }
+    PROFILE_COUNTER("trees placed", city->trees.size());
+}
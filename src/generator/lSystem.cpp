@@ -0,0 +1,45 @@
+#include <lSystem.hpp>
+#include <config.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#define LOG_LSYSTEM "LSYSTEM"
+
+bool lsystem::Grammar::Compile(std::string_view source, const std::string& name)
+{
+    *this = Grammar();
+    detail::CompileInto(source, *this);
+
+    if (error != nullptr)
+    {
+        const size_t line = std::count(source.begin(), source.begin() + std::min(errorPosition, source.size()), '\n') + 1;
+        LOG(ERROR_SERV(LOG_LSYSTEM), name << " line " << line << ": " << error);
+        return false;
+    }
+
+    // The 256 entry tables index productions with 16 bits
+    if (productionCount > UINT16_MAX)
+    {
+        LOG(ERROR_SERV(LOG_LSYSTEM), name << " has too many rules");
+        error = "too many rules";
+        return false;
+    }
+    return true;
+}
+
+
+bool lsystem::Grammar::LoadFile(const std::string& path)
+{
+    std::ifstream grammarFile(path);
+    if (!grammarFile.is_open())
+    {
+        LOG(ERROR_SERV(LOG_LSYSTEM), "Failed to open grammar file: " << path);
+        return false;
+    }
+
+    std::stringstream source;
+    source << grammarFile.rdbuf();
+    return Compile(source.str(), path);
+}
@@ -0,0 +1,140 @@
+#include <roadGeometry.hpp>
+
+RoadGeometry CalculateRoadGeometry(glm::vec3 point_a, glm::vec3 point_b, float width)
+{
+    RoadGeometry geometry;
+    const float radius = width/2;
+
+    // The naming of variables past this point "LEFT" is -z and "RIGHT" is +z (see Road::UpdateVertices)
+    // dont include Y component into unit vector as it causes the road to thin when normalizing
+    glm::vec3 unitVecAB = glm::normalize(glm::vec3{point_b.x, 0, point_b.z} - glm::vec3{point_a.x, 0, point_a.z});
+    glm::vec3 invUnitVecAB = glm::vec3{-unitVecAB.z, unitVecAB.y, unitVecAB.x};
+
+    glm::vec3 point_a_offset = {point_a.x + (radius * unitVecAB.x), point_a.y, point_a.z + (radius * unitVecAB.z)};
+    glm::vec3 leftA = point_a_offset + (invUnitVecAB * radius);
+    glm::vec3 rightA = point_a_offset - (invUnitVecAB * radius);
+
+    glm::vec3 point_b_offset = {point_b.x - (radius * unitVecAB.x), point_b.y, point_b.z - (radius * unitVecAB.z)};
+    glm::vec3 leftB = point_b_offset + (invUnitVecAB * radius);
+    glm::vec3 rightB = point_b_offset - (invUnitVecAB * radius);
+
+    glm::vec3 three = {leftA.x, point_a.y, leftA.z};
+    glm::vec3 four = {rightA.x, point_a.y, rightA.z};
+    glm::vec3 five = {leftB.x, point_b.y, leftB.z};
+    glm::vec3 six = {rightB.x, point_b.y, rightB.z};
+
+    //
+    // 4 vertices that fully encapsulate the road on the xz plane
+    //
+    glm::vec3 point_b_offset_out = {point_b.x + (radius * unitVecAB.x), point_b.y, point_b.z + (radius * unitVecAB.z)};
+    glm::vec3 topRightPoint = point_b_offset_out + (invUnitVecAB * radius);
+    glm::vec3 bottomRightPoint = point_b_offset_out - (invUnitVecAB * radius);
+
+    glm::vec3 point_a_offset_out = {point_a.x - (radius * unitVecAB.x), point_a.y, point_a.z - (radius * unitVecAB.z)};
+    glm::vec3 topLeftPoint = point_a_offset_out + (invUnitVecAB * radius);
+    glm::vec3 bottomLeftPoint = point_a_offset_out - (invUnitVecAB * radius);
+
+    geometry.obb = {topRightPoint, bottomRightPoint, bottomLeftPoint, topLeftPoint};
+
+    //
+    // We need the 8 vertices that will define out left and right zone for the zoning algorithm
+    // Radius*2 as we want the area besides to be as big as road, this can be changed later
+    //
+    // left zone, 3 and 5 used
+    glm::vec3 leftZone_topLeft = three + (invUnitVecAB * (radius*2));
+    glm::vec3 leftZone_topRight = five + (invUnitVecAB * (radius*2));
+    geometry.leftZone = {three, five, leftZone_topRight, leftZone_topLeft};
+
+    // Right zone, 4 and 6 used
+    glm::vec3 rightZone_bottomLeft = four - (invUnitVecAB * (radius*2));
+    glm::vec3 rightZone_bottomRight = six - (invUnitVecAB * (radius*2));
+    geometry.rightZone = {six, four, rightZone_bottomLeft, rightZone_bottomRight};
+
+    return geometry;
+}
+
+
+std::vector<PlacementArea> CalculatePlacementAreas(const std::array<glm::vec3, 4>& vertices, float width)
+{
+    std::vector<PlacementArea> areasForPlacement;
+
+    // Determine how many zones it has
+    float length = glm::length(vertices[0] - vertices[1]);
+    int sectionCount = glm::floor(length/width);
+
+    glm::vec3 newVec = (vertices[0] - vertices[1]);
+    glm::vec3 unitVector = newVec /= sectionCount;
+
+    float flip = 0;
+    if (vertices[0].x > vertices[1].x) { flip = M_PI; }
+
+    const float zoneAngle = CalculateZoneAngle(vertices);
+
+    for (int i = 0; i < sectionCount; i++)
+    {
+        glm::vec3 x = (unitVector * glm::vec3(i));
+        glm::vec3 placementVector = vertices[0] - x;
+
+        glm::vec3 invUnitVector = {-unitVector.z, unitVector.y, unitVector.x};
+
+        // Zone vertices
+        glm::vec3 one = placementVector;
+        glm::vec3 two = placementVector-unitVector;
+        glm::vec3 three = placementVector-invUnitVector;
+        glm::vec3 four = placementVector-unitVector-invUnitVector;
+
+        // This does this as an example
+        // 0 1 2 3 4 5 6 7 8 9 10 11 12 13 // Position
+        // 0 1 2 3 4 5 5 5 5 4 3  2  1  0  // Deepness
+        int deepness = 0;
+        constexpr int maxDeepness = 8;
+        // If first half
+        if (i < sectionCount/2)
+        {
+            if (i < maxDeepness) {deepness = i;}
+            else {deepness = maxDeepness;}
+        }
+        // Second half
+        else {
+            if ((sectionCount - i) > maxDeepness) {deepness = maxDeepness;}
+            else {deepness = sectionCount - (i+1);}
+        }
+
+        areasForPlacement.push_back({placementVector,
+                                     false,
+                                     zoneAngle+flip,
+                                     {one, two, four, three},
+                                     deepness});
+    }
+    return areasForPlacement;
+}
+
+
+float CalculateZoneAngle(const std::array<glm::vec3, 4>& vertices)
+{
+    return glm::atan((vertices[1].z - vertices[0].z)/(vertices[1].x - vertices[0].x));
+}
+
+
+BoundingCircle CalculateBoundingCircle(const std::array<glm::vec3, 4>& obb)
+{
+    // Center of the box and the distance from it to a corner
+    BoundingCircle circle;
+    circle.center = obb[0] + ((obb[1] - obb[0])/2.0f) + ((obb[2] - obb[1])/2.0f);
+    circle.radius = glm::length(circle.center-obb[0]);
+    return circle;
+}
+
+
+bool TooFarForCollision(const BoundingCircle& a, const BoundingCircle& b, const float threshold)
+{
+    // If the distance between the two radiuss of each road is above the thresold then we are good
+    return (glm::length(a.center-b.center) - a.radius - b.radius) > threshold;
+}
+
+
+bool TooFarForCollision(const std::array<glm::vec3, 4>& a, const std::array<glm::vec3, 4>& b, const float threshold)
+{
+    // Get radius of both roads from center to edge and then the threshold is the gap between the two radii
+    return TooFarForCollision(CalculateBoundingCircle(a), CalculateBoundingCircle(b), threshold);
+}
@@ -0,0 +1,102 @@
+#include <roadGraph.hpp>
+
+#include <cmath>
+
+int64_t RoadGraph::getBinCoord(float value) const
+{
+    return static_cast<int64_t>(std::floor(value / tolerance));
+}
+
+
+uint64_t RoadGraph::getBinKey(int64_t x, int64_t z)
+{
+    return (static_cast<uint64_t>(x) << 32) ^ static_cast<uint32_t>(z);
+}
+
+
+uint32_t RoadGraph::FindNode(const glm::vec3& position) const
+{
+    // Bins are as wide as the tolerance, so a node in range is in this bin or one next to it
+    const int64_t binX = getBinCoord(position.x);
+    const int64_t binZ = getBinCoord(position.z);
+    uint32_t closest = noNode;
+    for (int64_t x = binX - 1; x <= binX + 1; x++)
+    {
+        for (int64_t z = binZ - 1; z <= binZ + 1; z++)
+        {
+            auto head = binHeads.find(getBinKey(x, z));
+            if (head == binHeads.end())
+                continue;
+
+            // Lowest node wins so the result does not depend on the bin order
+            for (uint32_t node = head->second; node != noNode; node = nextInBin[node])
+            {
+                if (node < closest && glm::length(nodes[node] - position) <= tolerance)
+                {
+                    closest = node;
+                }
+            }
+        }
+    }
+    return closest;
+}
+
+
+void RoadGraph::Build(const std::vector<glm::vec3>& endpoints, float tolerance_in)
+{
+    tolerance = tolerance_in;
+    nodes.clear();
+    edges.clear();
+    binHeads.clear();
+    nextInBin.clear();
+
+    // Weld the endpoints, nodes are numbered in the order they are first seen
+    const size_t edgeCount = endpoints.size() / 2;
+    edges.reserve(edgeCount);
+    auto weld = [&](const glm::vec3& position)
+    {
+        uint32_t node = FindNode(position);
+        if (node == noNode)
+        {
+            node = nodes.size();
+            nodes.push_back(position);
+
+            uint32_t& head = binHeads.try_emplace(getBinKey(getBinCoord(position.x), getBinCoord(position.z)), noNode).first->second;
+            nextInBin.push_back(head);
+            head = node;
+        }
+        return node;
+    };
+    for (size_t i = 0; i < edgeCount; i++)
+    {
+        const uint32_t nodeA = weld(endpoints[2*i]);
+        const uint32_t nodeB = weld(endpoints[2*i + 1]);
+        edges.push_back({nodeA, nodeB});
+    }
+
+    // CSR adjacency, count the links of each node then fill them in edge order.
+    // A road short enough to weld into a single node links nowhere and is left out
+    offsets.assign(nodes.size() + 1, 0);
+    for (const Edge& edge : edges)
+    {
+        if (edge.nodeA == edge.nodeB)
+            continue;
+        offsets[edge.nodeA + 1]++;
+        offsets[edge.nodeB + 1]++;
+    }
+    for (size_t n = 0; n < nodes.size(); n++)
+    {
+        offsets[n + 1] += offsets[n];
+    }
+
+    links.resize(offsets.back());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (uint32_t e = 0; e < edges.size(); e++)
+    {
+        const Edge& edge = edges[e];
+        if (edge.nodeA == edge.nodeB)
+            continue;
+        links[fill[edge.nodeA]++] = {edge.nodeB, e};
+        links[fill[edge.nodeB]++] = {edge.nodeA, e};
+    }
+}
@@ -0,0 +1,261 @@
+#include <satBatch.hpp>
+
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+SATBox MakeSATBox(const std::array<glm::vec3, 4>& vertices)
+{
+    SATBox box;
+    for (int i = 0; i < 4; i++)
+    {
+        box.cornerX[i] = vertices[i].x;
+        box.cornerZ[i] = vertices[i].z;
+
+        // Same as glm::normalize(getPerpendicularXZ(edge)) so results match intersectsSAT
+        const glm::vec3 edge = vertices[(i + 1) % 4] - vertices[i];
+        const float length = 1.0f / std::sqrt(edge.z * edge.z + edge.x * edge.x);
+        box.normalX[i] = -edge.z * length;
+        box.normalZ[i] = edge.x * length;
+    }
+    return box;
+}
+
+
+void SATBoxBlock::Set(int lane, const SATBox& box)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        cornerX[i][lane] = box.cornerX[i];
+        cornerZ[i][lane] = box.cornerZ[i];
+        normalX[i][lane] = box.normalX[i];
+        normalZ[i][lane] = box.normalZ[i];
+    }
+}
+
+
+void SATBoxStore::Add(const SATBox& box)
+{
+    const int lane = count % SATBoxBlock::lanes;
+    if (lane == 0)
+    {
+        blocks.emplace_back();
+    }
+    blocks.back().Set(lane, box);
+    count++;
+}
+
+
+void SATBoxStore::Gather(const uint32_t* indices, int indexCount, SATBoxBlock& out) const
+{
+    for (int l = 0; l < indexCount; l++)
+    {
+        const SATBoxBlock& block = blocks[indices[l] / SATBoxBlock::lanes];
+        const int lane = indices[l] % SATBoxBlock::lanes;
+        for (int i = 0; i < 4; i++)
+        {
+            out.cornerX[i][l] = block.cornerX[i][lane];
+            out.cornerZ[i][l] = block.cornerZ[i][lane];
+            out.normalX[i][l] = block.normalX[i][lane];
+            out.normalZ[i][l] = block.normalZ[i][lane];
+        }
+    }
+}
+
+
+// Projection of the 4 corners of a box onto an axis
+inline void projectScalar(const float* cornerX, const float* cornerZ, float axisX, float axisZ, float& min, float& max)
+{
+    min = max = cornerX[0] * axisX + cornerZ[0] * axisZ;
+    for (int c = 1; c < 4; c++)
+    {
+        const float projection = cornerX[c] * axisX + cornerZ[c] * axisZ;
+        if (projection < min) min = projection;
+        if (projection > max) max = projection;
+    }
+}
+
+
+bool IntersectsSAT(const SATBox& a, const SATBox& b)
+{
+    float minA, maxA, minB, maxB;
+    for (int k = 0; k < 4; k++)
+    {
+        projectScalar(a.cornerX, a.cornerZ, a.normalX[k], a.normalZ[k], minA, maxA);
+        projectScalar(b.cornerX, b.cornerZ, a.normalX[k], a.normalZ[k], minB, maxB);
+        if (maxA <= minB + satLenience || maxB <= minA + satLenience) return false;
+    }
+    for (int k = 0; k < 4; k++)
+    {
+        projectScalar(a.cornerX, a.cornerZ, b.normalX[k], b.normalZ[k], minA, maxA);
+        projectScalar(b.cornerX, b.cornerZ, b.normalX[k], b.normalZ[k], minB, maxB);
+        if (maxA <= minB + satLenience || maxB <= minA + satLenience) return false;
+    }
+    return true;
+}
+
+
+#if defined(__AVX2__)
+
+// Projection of the 4 corners of 8 boxes onto 8 axes
+inline void project8(const float (*cornerX)[8], const float (*cornerZ)[8], __m256 axisX, __m256 axisZ, __m256& min, __m256& max)
+{
+    __m256 projection = _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(cornerX[0]), axisX), _mm256_mul_ps(_mm256_load_ps(cornerZ[0]), axisZ));
+    min = max = projection;
+    for (int c = 1; c < 4; c++)
+    {
+        projection = _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(cornerX[c]), axisX), _mm256_mul_ps(_mm256_load_ps(cornerZ[c]), axisZ));
+        min = _mm256_min_ps(min, projection);
+        max = _mm256_max_ps(max, projection);
+    }
+}
+
+// Projection of the 4 corners of one shape onto 8 axes
+inline void projectShape8(const SATBox& shape, __m256 axisX, __m256 axisZ, __m256& min, __m256& max)
+{
+    __m256 projection = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(shape.cornerX[0]), axisX), _mm256_mul_ps(_mm256_set1_ps(shape.cornerZ[0]), axisZ));
+    min = max = projection;
+    for (int c = 1; c < 4; c++)
+    {
+        projection = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(shape.cornerX[c]), axisX), _mm256_mul_ps(_mm256_set1_ps(shape.cornerZ[c]), axisZ));
+        min = _mm256_min_ps(min, projection);
+        max = _mm256_max_ps(max, projection);
+    }
+}
+
+// Lanes where the two projections are separated
+inline __m256 separated8(__m256 minA, __m256 maxA, __m256 minB, __m256 maxB)
+{
+    const __m256 lenience = _mm256_set1_ps(satLenience);
+    return _mm256_or_ps(_mm256_cmp_ps(maxA, _mm256_add_ps(minB, lenience), _CMP_LE_OQ),
+                        _mm256_cmp_ps(maxB, _mm256_add_ps(minA, lenience), _CMP_LE_OQ));
+}
+
+uint32_t IntersectsSATBatch(const SATBox& shape, const SATBoxBlock& block, int laneCount)
+{
+    __m256 separated = _mm256_setzero_ps();
+    __m256 minA, maxA, minB, maxB;
+
+    // Axes of the shape, the same for every lane
+    for (int k = 0; k < 4; k++)
+    {
+        float shapeMin, shapeMax;
+        projectScalar(shape.cornerX, shape.cornerZ, shape.normalX[k], shape.normalZ[k], shapeMin, shapeMax);
+        project8(block.cornerX, block.cornerZ, _mm256_set1_ps(shape.normalX[k]), _mm256_set1_ps(shape.normalZ[k]), minB, maxB);
+        separated = _mm256_or_ps(separated, separated8(_mm256_set1_ps(shapeMin), _mm256_set1_ps(shapeMax), minB, maxB));
+    }
+
+    // Axes of the boxes, one per lane
+    for (int k = 0; k < 4; k++)
+    {
+        const __m256 axisX = _mm256_load_ps(block.normalX[k]);
+        const __m256 axisZ = _mm256_load_ps(block.normalZ[k]);
+        projectShape8(shape, axisX, axisZ, minA, maxA);
+        project8(block.cornerX, block.cornerZ, axisX, axisZ, minB, maxB);
+        separated = _mm256_or_ps(separated, separated8(minA, maxA, minB, maxB));
+    }
+
+    const uint32_t laneMask = (1u << laneCount) - 1;
+    return ~static_cast<uint32_t>(_mm256_movemask_ps(separated)) & laneMask;
+}
+
+#elif defined(__SSE2__)
+
+// Projection of the 4 corners of 4 boxes (lanes offset to offset+3) onto 4 axes
+inline void project4(const float (*cornerX)[8], const float (*cornerZ)[8], int offset, __m128 axisX, __m128 axisZ, __m128& min, __m128& max)
+{
+    __m128 projection = _mm_add_ps(_mm_mul_ps(_mm_load_ps(cornerX[0] + offset), axisX), _mm_mul_ps(_mm_load_ps(cornerZ[0] + offset), axisZ));
+    min = max = projection;
+    for (int c = 1; c < 4; c++)
+    {
+        projection = _mm_add_ps(_mm_mul_ps(_mm_load_ps(cornerX[c] + offset), axisX), _mm_mul_ps(_mm_load_ps(cornerZ[c] + offset), axisZ));
+        min = _mm_min_ps(min, projection);
+        max = _mm_max_ps(max, projection);
+    }
+}
+
+// Projection of the 4 corners of one shape onto 4 axes
+inline void projectShape4(const SATBox& shape, __m128 axisX, __m128 axisZ, __m128& min, __m128& max)
+{
+    __m128 projection = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(shape.cornerX[0]), axisX), _mm_mul_ps(_mm_set1_ps(shape.cornerZ[0]), axisZ));
+    min = max = projection;
+    for (int c = 1; c < 4; c++)
+    {
+        projection = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(shape.cornerX[c]), axisX), _mm_mul_ps(_mm_set1_ps(shape.cornerZ[c]), axisZ));
+        min = _mm_min_ps(min, projection);
+        max = _mm_max_ps(max, projection);
+    }
+}
+
+// Lanes where the two projections are separated
+inline __m128 separated4(__m128 minA, __m128 maxA, __m128 minB, __m128 maxB)
+{
+    const __m128 lenience = _mm_set1_ps(satLenience);
+    return _mm_or_ps(_mm_cmple_ps(maxA, _mm_add_ps(minB, lenience)),
+                     _mm_cmple_ps(maxB, _mm_add_ps(minA, lenience)));
+}
+
+uint32_t IntersectsSATBatch(const SATBox& shape, const SATBoxBlock& block, int laneCount)
+{
+    uint32_t result = 0;
+    __m128 minA, maxA, minB, maxB;
+
+    // Two halves of 4 lanes
+    for (int offset = 0; offset < laneCount; offset += 4)
+    {
+        __m128 separated = _mm_setzero_ps();
+
+        // Axes of the shape, the same for every lane
+        for (int k = 0; k < 4; k++)
+        {
+            float shapeMin, shapeMax;
+            projectScalar(shape.cornerX, shape.cornerZ, shape.normalX[k], shape.normalZ[k], shapeMin, shapeMax);
+            project4(block.cornerX, block.cornerZ, offset, _mm_set1_ps(shape.normalX[k]), _mm_set1_ps(shape.normalZ[k]), minB, maxB);
+            separated = _mm_or_ps(separated, separated4(_mm_set1_ps(shapeMin), _mm_set1_ps(shapeMax), minB, maxB));
+        }
+
+        // Axes of the boxes, one per lane
+        for (int k = 0; k < 4; k++)
+        {
+            const __m128 axisX = _mm_load_ps(block.normalX[k] + offset);
+            const __m128 axisZ = _mm_load_ps(block.normalZ[k] + offset);
+            projectShape4(shape, axisX, axisZ, minA, maxA);
+            project4(block.cornerX, block.cornerZ, offset, axisX, axisZ, minB, maxB);
+            separated = _mm_or_ps(separated, separated4(minA, maxA, minB, maxB));
+        }
+
+        result |= (~static_cast<uint32_t>(_mm_movemask_ps(separated)) & 0xF) << offset;
+    }
+
+    const uint32_t laneMask = (1u << laneCount) - 1;
+    return result & laneMask;
+}
+
+#else
+
+uint32_t IntersectsSATBatch(const SATBox& shape, const SATBoxBlock& block, int laneCount)
+{
+    uint32_t result = 0;
+    for (int l = 0; l < laneCount; l++)
+    {
+        SATBox box;
+        for (int i = 0; i < 4; i++)
+        {
+            box.cornerX[i] = block.cornerX[i][l];
+            box.cornerZ[i] = block.cornerZ[i][l];
+            box.normalX[i] = block.normalX[i][l];
+            box.normalZ[i] = block.normalZ[i][l];
+        }
+        if (IntersectsSAT(shape, box))
+        {
+            result |= 1u << l;
+        }
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,89 @@
+#include <segmentBvh.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+void SegmentBVH::Build(const std::vector<glm::vec2>& min, const std::vector<glm::vec2>& max)
+{
+    const uint32_t count = min.size();
+    nodes.clear();
+    segments.resize(count);
+    std::iota(segments.begin(), segments.end(), 0);
+    if (count == 0)
+        return;
+
+    std::vector<glm::vec2> centres(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        centres[i] = (min[i] + max[i]) * 0.5f;
+    }
+
+    // A binary tree with leaves of at least leafSize/2 segments has under count nodes
+    nodes.reserve(count * 2);
+    nodes.push_back({});
+    build(0, 0, count, min, max, centres);
+}
+
+
+void SegmentBVH::build(uint32_t node, uint32_t first, uint32_t count, const std::vector<glm::vec2>& min,
+                       const std::vector<glm::vec2>& max, const std::vector<glm::vec2>& centres)
+{
+    glm::vec2 boundsMin = min[segments[first]], boundsMax = max[segments[first]];
+    glm::vec2 centreMin = centres[segments[first]], centreMax = centreMin;
+    for (uint32_t i = first + 1; i < first + count; i++)
+    {
+        const uint32_t segment = segments[i];
+        boundsMin = glm::min(boundsMin, min[segment]);
+        boundsMax = glm::max(boundsMax, max[segment]);
+        centreMin = glm::min(centreMin, centres[segment]);
+        centreMax = glm::max(centreMax, centres[segment]);
+    }
+    nodes[node].min = boundsMin;
+    nodes[node].max = boundsMax;
+
+    if (count <= leafSize)
+    {
+        nodes[node].first = first;
+        nodes[node].count = count;
+        return;
+    }
+
+    // Median of the centres along the longer axis, each half gets the same number of segments
+    const int axis = (centreMax.x - centreMin.x) >= (centreMax.y - centreMin.y) ? 0 : 1;
+    const uint32_t half = count / 2;
+    std::nth_element(segments.begin() + first, segments.begin() + first + half, segments.begin() + first + count,
+        [&](uint32_t lhs, uint32_t rhs) { return centres[lhs][axis] < centres[rhs][axis]; });
+
+    const uint32_t children = nodes.size();
+    nodes[node].first = children;
+    nodes[node].count = 0;
+    nodes.push_back({});
+    nodes.push_back({});
+    build(children, first, half, min, max, centres);
+    build(children + 1, first + half, count - half, min, max, centres);
+}
+
+
+bool SegmentBVH::passesThrough(glm::vec2 a, glm::vec2 b, glm::vec2 min, glm::vec2 max)
+{
+    float enter = 0.0f, exit = 1.0f;
+    for (int axis = 0; axis < 2; axis++)
+    {
+        const float direction = b[axis] - a[axis];
+        if (direction == 0.0f)
+        {
+            if (a[axis] < min[axis] || a[axis] > max[axis])
+                return false;
+            continue;
+        }
+
+        float t1 = (min[axis] - a[axis]) / direction;
+        float t2 = (max[axis] - a[axis]) / direction;
+        if (t1 > t2) { std::swap(t1, t2); }
+        enter = std::max(enter, t1);
+        exit = std::min(exit, t2);
+        if (enter > exit)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,78 @@
+#include <spatialGrid.hpp>
+
+#include <algorithm>
+
+SpatialGrid::SpatialGrid(float cellSize) : cellSize(cellSize), invCellSize(1.0f/cellSize)
+{
+}
+
+
+void SpatialGrid::Insert(uint32_t id, glm::vec2 min, glm::vec2 max)
+{
+    const int32_t minX = GetCellCoord(min.x), maxX = GetCellCoord(max.x);
+    const int32_t minZ = GetCellCoord(min.y), maxZ = GetCellCoord(max.y);
+
+    for (int32_t x = minX; x <= maxX; x++)
+    {
+        for (int32_t z = minZ; z <= maxZ; z++)
+        {
+            cells[GetKey(x, z)].push_back(id);
+        }
+    }
+}
+
+
+void SpatialGrid::Remove(uint32_t id, glm::vec2 min, glm::vec2 max)
+{
+    const int32_t minX = GetCellCoord(min.x), maxX = GetCellCoord(max.x);
+    const int32_t minZ = GetCellCoord(min.y), maxZ = GetCellCoord(max.y);
+
+    for (int32_t x = minX; x <= maxX; x++)
+    {
+        for (int32_t z = minZ; z <= maxZ; z++)
+        {
+            auto cell = cells.find(GetKey(x, z));
+            if (cell == cells.end())
+                continue;
+
+            // Order within a cell does not matter as queries are sorted, swap remove
+            auto& ids = cell->second;
+            auto it = std::find(ids.begin(), ids.end(), id);
+            if (it != ids.end())
+            {
+                *it = ids.back();
+                ids.pop_back();
+            }
+        }
+    }
+}
+
+
+void SpatialGrid::Query(glm::vec2 min, glm::vec2 max, std::vector<uint32_t>& out) const
+{
+    out.clear();
+    const int32_t minX = GetCellCoord(min.x), maxX = GetCellCoord(max.x);
+    const int32_t minZ = GetCellCoord(min.y), maxZ = GetCellCoord(max.y);
+
+    for (int32_t x = minX; x <= maxX; x++)
+    {
+        for (int32_t z = minZ; z <= maxZ; z++)
+        {
+            auto cell = cells.find(GetKey(x, z));
+            if (cell != cells.end())
+            {
+                out.insert(out.end(), cell->second.begin(), cell->second.end());
+            }
+        }
+    }
+
+    // Objects spanning several cells are found more than once
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+
+void SpatialGrid::Clear(void)
+{
+    cells.clear();
+}
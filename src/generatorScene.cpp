@@ -0,0 +1,356 @@
+#include <generator.hpp>
+
+#include <config.hpp>
+#include <scene.hpp>
+#include <road_object.hpp>
+#include <stopwatch.hpp>
+#include <cityEditor.hpp>
+#include <cityCache.hpp>
+#include <citySnapshot.hpp>
+#include <profiler.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
+// Scene side of the generator, everything here needs the renderer and an OpenGL context.
+// The generation itself is in src/generator/ so it can be built headless.
+
+// The last city from GenerateCity, kept so a road edit only redoes what is around the road
+struct GeneratedCity
+{
+    CityData city;
+    CitySceneObjects objects;   // Roads by road index, buildings and trees until the editor is built
+
+    // Built on the first edit so generating a city does not pay for it
+    std::unique_ptr<CityEditor> editor;
+    std::unordered_map<uint64_t, ModelObject*> buildings;
+    std::unordered_map<uint64_t, SpriteObject*> trees;
+};
+static std::unique_ptr<GeneratedCity> generatedCity;
+
+
+static SpriteObject* addSceneTree(const CityTree& tree)
+{
+    SpriteObject* sceneTree = Scene::getInstance()->addSprite(paths::treeSpritePath);
+    sceneTree->SetModelOriginCenterBottom()
+        ->SetIsVisible(true)
+        ->SetIsBillboard(true)
+        ->SetScale(0.4f)
+        ->SetPosition(tree.position)
+        ->SetLightingEnabled(true);
+    return sceneTree;
+}
+
+
+static ModelObject* addSceneBuilding(const CityBuilding& building)
+{
+    Scene* scene = Scene::getInstance();
+    ShaderPath buildingShader = {paths::building_defaultInstancedVertShaderPath, paths::building_defaultFragShaderPath};
+    ModelObject* sceneBuilding = scene->addModel(std::string(paths::buildingModelPaths[building.modelIndex]), &buildingShader, true);
+    sceneBuilding->SetOriginFrontLeft()
+        ->SetPosition(building.position)
+        ->ShowBoundingBox(false)
+        ->SetRotation(glm::vec3{0, building.angle, 0})
+        ->SetScale(building.scale)
+        ->SetLightingEnabled(true);
+    // Only this instance's matrix is written again, not the whole renderer's
+    scene->GetModelInstanceRenderer(sceneBuilding)->Update(sceneBuilding);
+    return sceneBuilding;
+}
+
+
+int generator::GenerateCity(unsigned int seed_in)
+{
+    // Every generation is traced, open the file in chrome://tracing to see where a seed spends its time
+    Profiler::getInstance()->BeginSession();
+    {
+        PROFILE_SCOPE("GenerateCity");
+        generatedCity = std::make_unique<GeneratedCity>();
+        CityData& city = generatedCity->city;
+
+        // A seed generated before is read back from the cache, a new city has no seed to look up yet.
+        // Only seeds asked for are written, a random city is unlikely to be asked for again
+        if (seed_in == 0)
+        {
+            city = GenerateCityData(seed_in);
+        }
+        else if (!ReadCityCache(GetGenerationKey(seed_in), city))
+        {
+            city = GenerateCityData(seed_in);
+            WriteCityCache(city, GetGenerationKey(city.seed));
+        }
+        PopulateScene(city, &generatedCity->objects);
+    }
+    Profiler::getInstance()->EndSession(paths::generationTracePath);
+    return generatedCity->city.seed;
+}
+
+
+void generator::ForgetGeneratedCity(void)
+{
+    generatedCity.reset();
+}
+
+
+void generator::ForgetGeneratedCityObject(const void* object)
+{
+    if (generatedCity == nullptr)
+        return;
+
+    // Only a user delete calls this, a scan is fine
+    const GeneratedCity& generated = *generatedCity;
+    auto has = [object](const auto& objects) { return std::find(objects.begin(), objects.end(), object) != objects.end(); };
+    auto hasValue = [object](const auto& map)
+    {
+        return std::any_of(map.begin(), map.end(), [object](const auto& entry) { return entry.second == object; });
+    };
+    if (has(generated.objects.roads) || has(generated.objects.buildings) || has(generated.objects.trees) ||
+        hasValue(generated.buildings) || hasValue(generated.trees))
+    {
+        LOG(STATUS, "City object deleted, road edits no longer update the city");
+        ForgetGeneratedCity();
+    }
+}
+
+
+void generator::UpdateEditedRoad(RoadObject* road)
+{
+    if (generatedCity == nullptr)
+        return;
+
+    const auto& roads = generatedCity->objects.roads;
+    auto it = std::find(roads.begin(), roads.end(), road);
+    if (it == roads.end())
+        return;
+    const size_t roadIndex = it - roads.begin();
+
+    PROFILE_SCOPE("UpdateEditedRoad");
+    LOG(STATUS, "[ Started UpdateEditedRoad ]");
+    auto updateStartTime = StopWatch::GetCurrentTimePoint();
+
+    GeneratedCity& generated = *generatedCity;
+    if (generated.editor == nullptr)
+    {
+        // The editor gives buildings and trees in the order PopulateScene created them
+        generated.editor = std::make_unique<CityEditor>(generated.city);
+        if (generated.editor->GetBuildings().size() != generated.objects.buildings.size() ||
+            generated.editor->GetTrees().size() != generated.objects.trees.size())
+        {
+            // A city not made by this build's generator, such as an old cache file
+            LOG(WARN, "City editor rebuilt " << generated.editor->GetBuildings().size() << " buildings and " << generated.editor->GetTrees().size()
+                << " trees, the scene has " << generated.objects.buildings.size() << " and " << generated.objects.trees.size()
+                << ". Road edits no longer update the city");
+            ForgetGeneratedCity();
+            return;
+        }
+        size_t i = 0;
+        for (const auto& building : generated.editor->GetBuildings()) { generated.buildings[building.first] = generated.objects.buildings[i++]; }
+        i = 0;
+        for (const auto& tree : generated.editor->GetTrees()) { generated.trees[tree.first] = generated.objects.trees[i++]; }
+        generated.city = CityData();
+        generated.objects.buildings.clear();
+        generated.objects.trees.clear();
+    }
+
+    CityEdit edit = generated.editor->UpdateRoad(roadIndex, road->GetPointA(), road->GetPointB(), road->GetWidth());
+
+    Scene* scene = Scene::getInstance();
+    for (size_t r : edit.zoneRoads)
+    {
+        roads[r]->GetZoneA()->SetZoneUsable(generated.editor->GetRoad(r).zoneA.usable);
+        roads[r]->GetZoneB()->SetZoneUsable(generated.editor->GetRoad(r).zoneB.usable);
+    }
+
+    // Removals first, an edit can remove and add back the same key
+    for (uint64_t key : edit.removedBuildings)
+    {
+        ModelObject* building = generated.buildings[key];
+        scene->destroyModel(building);
+        generated.buildings.erase(key);
+    }
+    for (const auto& [key, building] : edit.addedBuildings)
+    {
+        generated.buildings[key] = addSceneBuilding(building);
+    }
+    for (uint64_t key : edit.removedTrees)
+    {
+        SpriteObject* tree = generated.trees[key];
+        scene->destroySprite(tree);
+        generated.trees.erase(key);
+    }
+    for (const auto& [key, tree] : edit.addedTrees)
+    {
+        generated.trees[key] = addSceneTree(tree);
+    }
+
+    uint64_t timeElapsed = StopWatch::GetTimeElapsed(updateStartTime);
+    LOG(STATUS, "Zones recomputed: " << edit.zoneRoads.size() << ", buildings -" << edit.removedBuildings.size() << " +" << edit.addedBuildings.size()
+        << ", trees -" << edit.removedTrees.size() << " +" << edit.addedTrees.size());
+    LOG(STATUS, "[ UpdateEditedRoad finished. Time elapsed: " << timeElapsed << "ms ]\n");
+}
+
+
+void generator::PopulateScene(const CityData& city, CitySceneObjects* objects)
+{
+    PROFILE_SCOPE("PopulateScene");
+    LOG(STATUS, "[ Started PopulateScene ]");
+    auto populateStartTime = StopWatch::GetCurrentTimePoint();
+
+    Scene* scene = Scene::getInstance();
+
+    // Then we add to the scene for rendering
+    {
+        PROFILE_SCOPE("AddRoads");
+        std::vector<RoadObject*> sceneRoads;
+        sceneRoads.reserve(city.roads.size());
+        for (auto& road : city.roads)
+        {
+            auto sceneRoad = scene->addRoad(road.a, road.b, road.width);
+            sceneRoad->GetZoneA()->SetZoneUsable(road.zoneA.usable);
+            sceneRoad->GetZoneB()->SetZoneUsable(road.zoneB.usable);
+            sceneRoads.push_back(sceneRoad);
+        }
+        // Only the new roads are uploaded, a streamed chunk does not write the roads of the chunks already loaded
+        scene->roadBatchRenderer->Append(sceneRoads);
+        if (objects != nullptr) { objects->roads.insert(objects->roads.end(), sceneRoads.begin(), sceneRoads.end()); }
+        PROFILE_COUNTER("roads", city.roads.size());
+    }
+
+    {
+        PROFILE_SCOPE("AddTrees");
+        for (auto& tree : city.trees)
+        {
+            SpriteObject* sceneTree = addSceneTree(tree);
+            if (objects != nullptr) { objects->trees.push_back(sceneTree); }
+        }
+        PROFILE_COUNTER("trees", city.trees.size());
+    }
+
+    {
+        PROFILE_SCOPE("AddBuildings");
+        for (auto& building : city.buildings)
+        {
+            ModelObject* sceneBuilding = addSceneBuilding(building);
+            if (objects != nullptr) { objects->buildings.push_back(sceneBuilding); }
+        }
+        PROFILE_COUNTER("buildings", city.buildings.size());
+    }
+
+    uint64_t timeElapsed = StopWatch::GetTimeElapsed(populateStartTime);
+    LOG(STATUS, "[ PopulateScene finished. Time elapsed: " << timeElapsed << "ms ]\n");
+}
+
+
+bool generator::SaveCitySnapshot(const std::string& path, unsigned int seed)
+{
+    PROFILE_SCOPE("SaveCitySnapshot");
+    Scene* scene = Scene::getInstance();
+    CitySnapshotContents contents;
+    contents.seed = seed;
+
+    for (RoadObject* road : scene->GetRoadObjects())
+    {
+        contents.roadPoints.push_back(road->GetPointA());
+        contents.roadPoints.push_back(road->GetPointB());
+        contents.roadWidths.push_back(road->GetWidth());
+        contents.roadZoneBits.push_back((road->GetZoneA()->IsUsable() ? SNAPSHOT_ZONE_A_USABLE : 0) |
+                                        (road->GetZoneB()->IsUsable() ? SNAPSHOT_ZONE_B_USABLE : 0));
+    }
+
+    // The instance renderers already hold the matrix of every building, make sure moved ones are current
+    scene->ForceReloadInstanceRendererData();
+    contents.buildingTransforms.resize(paths::buildingModelPaths.size());
+    for (auto& ir : scene->GetModelInstanceRenderers())
+    {
+        // Models that are not buildings are not part of the city
+        auto model = std::find(paths::buildingModelPaths.begin(), paths::buildingModelPaths.end(), ir->GetInstanceType()->GetModelPath());
+        if (model == paths::buildingModelPaths.end())
+            continue;
+        contents.buildingTransforms[model - paths::buildingModelPaths.begin()] = ir->GetMatrices();
+    }
+
+    for (SpriteObject* sprite : scene->GetSpriteObjects())
+    {
+        if (sprite->GetSpritePath() == paths::treeSpritePath)
+        {
+            contents.treePositions.push_back(sprite->GetPosition());
+        }
+    }
+    return WriteCitySnapshot(path, contents);
+}
+
+
+bool generator::LoadCitySnapshot(const std::string& path, unsigned int* seed)
+{
+    PROFILE_SCOPE("LoadCitySnapshot");
+    LOG(STATUS, "[ Started LoadCitySnapshot ]");
+    auto loadStartTime = StopWatch::GetCurrentTimePoint();
+
+    CitySnapshot snapshot;
+    if (!snapshot.Open(path))
+    {
+        LOG(ERROR, "Could not load city snapshot " << path);
+        return false;
+    }
+    // Nothing of a snapshot is kept for road edits
+    ForgetGeneratedCity();
+    Scene* scene = Scene::getInstance();
+
+    {
+        PROFILE_SCOPE("AddRoads");
+        const glm::vec3* points = snapshot.GetRoadPoints();
+        const float* widths = snapshot.GetRoadWidths();
+        const uint8_t* zoneBits = snapshot.GetRoadZoneBits();
+        for (uint32_t i = 0; i < snapshot.GetRoadCount(); i++)
+        {
+            auto sceneRoad = scene->addRoad(points[2*i], points[2*i + 1], widths[i]);
+            sceneRoad->GetZoneA()->SetZoneUsable(zoneBits[i] & SNAPSHOT_ZONE_A_USABLE);
+            sceneRoad->GetZoneB()->SetZoneUsable(zoneBits[i] & SNAPSHOT_ZONE_B_USABLE);
+        }
+        scene->roadBatchRenderer->UpdateAll();
+        PROFILE_COUNTER("roads", snapshot.GetRoadCount());
+    }
+
+    {
+        // The matrices of each model go to its instance renderer in one copy out of the mapped file
+        PROFILE_SCOPE("AddBuildings");
+        ShaderPath buildingShader = {paths::building_defaultInstancedVertShaderPath, paths::building_defaultFragShaderPath};
+        const uint32_t modelCount = std::min<uint32_t>(snapshot.GetModelCount(), paths::buildingModelPaths.size());
+        for (uint32_t model = 0; model < modelCount; model++)
+        {
+            uint32_t count = 0;
+            const float* transforms = snapshot.GetBuildingTransforms(model, &count);
+            scene->addModelInstances(std::string(paths::buildingModelPaths[model]), &buildingShader, transforms, count);
+        }
+    }
+
+    {
+        // Trees are billboards, which the sprite instance renderer does not draw, so they stay objects
+        PROFILE_SCOPE("AddTrees");
+        const glm::vec3* positions = snapshot.GetTreePositions();
+        for (uint32_t i = 0; i < snapshot.GetTreeCount(); i++)
+        {
+            addSceneTree({positions[i]});
+        }
+        PROFILE_COUNTER("trees", snapshot.GetTreeCount());
+    }
+
+    if (seed != nullptr) { *seed = snapshot.GetSeed(); }
+    uint64_t timeElapsed = StopWatch::GetTimeElapsed(loadStartTime);
+    LOG(STATUS, "[ LoadCitySnapshot finished. Time elapsed: " << timeElapsed << "ms ]\n");
+    return true;
+}
+
+
+// Reset colour back to green
+void generator::ClearZoneCollisions()
+{
+    std::vector<RoadObject*> roads = Scene::getInstance()->GetRoadObjects();
+
+    for (auto& road : roads)
+    {
+        road->GetZoneA()->SetColour(GREEN);
+        road->GetZoneB()->SetColour(GREEN);
+    }
+}
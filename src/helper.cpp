@@ -51,3 +51,31 @@ glm::vec3 getPerpendicularXZ(glm::vec3 vector)
     return returnVector;
 }
 
+
+
+// Checks if two orienteted rectangles collide, using SAT - seperate axis theorem
+bool intersectsSAT(const std::array<glm::vec3, 4>& a, const std::array<glm::vec3, 4>& b)
+{
+    // First we check the axis of our zone
+    std::array<glm::vec3, 8> axis;
+
+    size_t i;
+    // Get all 4 edges of both rectangles
+    for (i = 0; i < 4; i++)
+    {
+        // Get each vector of each edge and then get its perits adjacent one and then put them into a bix array
+        axis[i] = glm::normalize(getPerpendicularXZ(a[(i + 1) % 4] - a[i]));
+        axis[i+4] = glm::normalize(getPerpendicularXZ(b[(i + 1) % 4] - b[i]));
+    }
+
+    for (i = 0; i < 8; i++)
+    {
+        if (!projectionOverlap(a, b, axis[i]))
+        {
+            return false;
+        }
+    }
+
+    // Does not intersect
+    return true;
+}
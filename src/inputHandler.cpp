@@ -1,6 +1,7 @@
 #include <inputHandler.hpp>
 #include <iostream>
 #include <scene.hpp>
+#include <generator.hpp>
 
 bool InputHandler::showMouse = false;
 
@@ -179,6 +180,7 @@ void InputHandler::process(GLFWwindow *window, double deltaTime)
             {
                 case(SceneType::MODEL):
                 {
+                    generator::ForgetGeneratedCityObject(scene->sceneSelectedObject->GetObject());
                     // Remove the model from the scene
                     scene->removeModel(*static_cast<ModelObject*>(scene->sceneSelectedObject->GetObject()));
                     scene->sceneSelectedObject->Deselect();
@@ -186,12 +188,14 @@ void InputHandler::process(GLFWwindow *window, double deltaTime)
                 }
                 case(SceneType::ROAD):
                 {
+                    generator::ForgetGeneratedCityObject(scene->sceneSelectedObject->GetObject());
                     scene->roadBatchRenderer->Delete(static_cast<const RoadObject*>(scene->sceneSelectedObject->GetObject()));
                     scene->sceneSelectedObject->Deselect();
                     break;
                 }
                 case(SceneType::SPRITE):
                 {
+                    generator::ForgetGeneratedCityObject(scene->sceneSelectedObject->GetObject());
                     scene->removeSprite(*static_cast<SpriteObject*>(scene->sceneSelectedObject->GetObject()));
                     scene->sceneSelectedObject->Deselect();
                     break;
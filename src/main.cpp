@@ -27,6 +27,7 @@
 #include <scene.hpp>
 #include <renderer.hpp>
 #include <generator.hpp>
+#include <chunkStreamer.hpp>
 #include <road.hpp>
 
 // Prototypes
@@ -312,6 +313,9 @@ int main() {
         camera->UpdateWindowDimentions(windowWidth, windowHeight);
 
         Menues::display(deltaTime);
+
+        // Load and unload world chunks around the camera when streaming
+        ChunkStreamer::getInstance()->Update(camera->Position);
         
         scene->DrawScene();
 
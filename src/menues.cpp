@@ -2,6 +2,8 @@
 #include <menues.hpp>
 #include <resourceManager.hpp>
 #include <generator.hpp>
+#include <chunkStreamer.hpp>
+#include <scene.hpp>
 #include <string>
 
 #include <camera.hpp>
@@ -95,6 +97,7 @@ void Menues::display(float deltaTime)
                 if (deleteModel)
                 {
                     // Delete and unfocus so the user cant control the object anymore
+                    generator::ForgetGeneratedCityObject(object);
                     scene->removeModel(*object);
                     scene->sceneSelectedObject->Deselect();
                     // ImGui::SetWindowFocus(nullptr);
@@ -175,6 +178,7 @@ void Menues::display(float deltaTime)
                     LOG(STATUS, "Point B: " << road->GetPointB());
 
                     LOG(STATUS, "DELETE ROAD");
+                    generator::ForgetGeneratedCityObject(road);
                     scene->roadBatchRenderer->Delete(road);
                     scene->sceneSelectedObject->Deselect();
                     // LOG(STATUS, "Functionallity not implemented");
@@ -187,6 +191,8 @@ void Menues::display(float deltaTime)
                     pointB_Before = road->GetPointB();
                     widthBefore = road->GetWidth();
                     road->UpdateRoadAndBatch();
+                    // Redo the zones and buildings around it if it is a generated road
+                    generator::UpdateEditedRoad(road);
                 }
                 break;
             }
@@ -215,6 +221,7 @@ void Menues::display(float deltaTime)
                 bool deleteSprite = ImGui::Button("Delete");
                 if (deleteSprite)
                 {
+                    generator::ForgetGeneratedCityObject(sprite);
                     scene->removeSprite(*sprite);
                     scene->sceneSelectedObject->Deselect();
                 }
@@ -335,18 +342,23 @@ void Menues::display(float deltaTime)
         static long menu_seed = 0;
         ImGui::Text("Seed: %ld", menu_seed);
         
+        // Streamed chunks and the generated city are let go first, the removeAll methods delete the objects they still point at
+        ChunkStreamer* streamer = ChunkStreamer::getInstance();
+
         bool removeModels = ImGui::Button("Remove all models");
-        if (removeModels) { scene->removeAllModels(); }
+        if (removeModels) { streamer->Stop(); generator::ForgetGeneratedCity(); scene->removeAllModels(); }
 
         bool removeRoads = ImGui::Button("Remove all roads.");
-        if (removeRoads) { scene->removeAllRoads(); }
+        if (removeRoads) { streamer->Stop(); generator::ForgetGeneratedCity(); scene->removeAllRoads(); }
 
         bool removeSprites = ImGui::Button("Remove all sprites");
-        if (removeSprites) { scene->removeAllSprites(); } 
+        if (removeSprites) { streamer->Stop(); generator::ForgetGeneratedCity(); scene->removeAllSprites(); } 
 
         bool removeEverything = ImGui::Button("Remove everything");
         if (removeEverything)
         {
+            streamer->Stop();
+            generator::ForgetGeneratedCity();
             scene->removeAllModels();
             scene->removeAllRoads();
             scene->removeAllSprites();
@@ -357,6 +369,8 @@ void Menues::display(float deltaTime)
         bool generateRoads = ImGui::Button("Clear and Generate.");
         if (generateRoads)
         {
+            streamer->Stop();
+            generator::ForgetGeneratedCity();
             scene->removeAllModels();
             scene->removeAllRoads();
             scene->removeAllSprites();
@@ -387,6 +401,47 @@ void Menues::display(float deltaTime)
         ImGui::Text("Seed:");
         ImGui::InputText("##seedInput", textBuffer, 20);
 
+        // Snapshot of the city in the scene, loading it replaces the scene
+        bool saveSnapshot = ImGui::Button("Save city snapshot.");
+        if (saveSnapshot) { generator::SaveCitySnapshot(paths::citySnapshotPath, menu_seed); }
+        ImGui::SameLine();
+        bool loadSnapshot = ImGui::Button("Load city snapshot.");
+        if (loadSnapshot)
+        {
+            streamer->Stop();
+            generator::ForgetGeneratedCity();
+            scene->removeAllModels();
+            scene->removeAllRoads();
+            scene->removeAllSprites();
+            unsigned int snapshotSeed = 0;
+            if (generator::LoadCitySnapshot(paths::citySnapshotPath, &snapshotSeed)) { menu_seed = snapshotSeed; }
+        }
+
+        // Off keeps the cities of existing seeds, changing it while streaming leaves chunks that do not match
+        bool splitCrossings = generator::GetCrossingPolicy() == CrossingPolicy::SPLIT;
+        if (ImGui::Checkbox("Split crossing roads", &splitCrossings))
+        {
+            generator::SetCrossingPolicy(splitCrossings ? CrossingPolicy::SPLIT : CrossingPolicy::REMOVE);
+        }
+
+        // Tiled world generated around the camera as it moves, uses the seed above
+        ImGui::NewLine();
+        if (!streamer->IsActive())
+        {
+            bool startStreaming = ImGui::Button("Stream chunks around camera.");
+            if (startStreaming)
+            {
+                menu_seed = streamer->Start(std::strcmp(textBuffer, "") ? std::stoi(textBuffer) : 0);
+            }
+        }
+        else
+        {
+            bool stopStreaming = ImGui::Button("Stop streaming.");
+            if (stopStreaming) { streamer->Stop(); }
+        }
+        ImGui::SliderFloat("Chunk load radius", &streamer->GetLoadRadiusImGui(), chunkSize/2, chunkSize*4);
+        ImGui::Text("Chunks loaded [%ld] generating [%ld]", streamer->GetLoadedChunkCount(), streamer->GetPendingChunkCount());
+
         ImGui::TreePop();
     }
     
@@ -728,6 +783,7 @@ void Menues::display(float deltaTime)
                     bool deleteBtn = ImGui::Button("Delete");
                     if (deleteBtn)
                     {
+                        generator::ForgetGeneratedCityObject(object);
                         scene->removeModel(*object);
                     }
                 }
@@ -770,6 +826,7 @@ void Menues::display(float deltaTime)
                     bool deleteBtn = ImGui::Button("Delete");
                     if (deleteBtn)
                     {
+                        generator::ForgetGeneratedCityObject(object);
                         scene->removeSprite(*object);
                     }
                 }
@@ -111,12 +111,14 @@ void ModelObject::DrawBoundingBox(glm::vec3 colour)
 
 glm::mat4 ModelObject::GetModelMatrix(void)
 {
-    return glm::mat4(1.0f) * 
-        getPositionMat4(position) * 
-        getRotateMat4(rotation) * 
-        getScaleMat4(scaleScalar) * 
-        getScaleMat4(scale) / 
-        getPositionMat4(objectOriginPosition); // To set the models origin
+    // position * rotation * scale, moved by the origin first. Built directly instead of multiplying
+    // the four matrices and inverting the origin translation
+    return ComputeModelMatrix(GetInstanceTransform());
+}
+
+InstanceTransform ModelObject::GetInstanceTransform(void) const
+{
+    return {position, rotation, scaleScalar * scale, objectOriginPosition};
 }
 
 // Model specific builders
@@ -231,6 +233,11 @@ std::string ModelObject::GetModelPath() const
     return model->GetModelPath();
 }
 
+AssetId ModelObject::GetModelAssetId() const
+{
+    return model->GetAssetId();
+}
+
 bool ModelObject::GetShowBoundingBox() const
 {
     return showBoundingBox;
@@ -30,58 +30,8 @@ void RoadZoneObject::UpdateVertices(const std::array<glm::vec3, 4>& vertices_in,
     vertices = vertices_in;
     zone_renderer->UpdateVertices(vertices_in, width_in);
 
-    // Determine how many zones it has
-    float length = glm::length(vertices_in[0] - vertices_in[1]);
-    int sectionCount = glm::floor(length/width_in);
-
-    glm::vec3 newVec = (vertices_in[0] - vertices_in[1]);
-    glm::vec3 unitVector = newVec /= sectionCount;
-
-    float flip = 0;
-    if (vertices[0].x > vertices[1].x) { flip = M_PI; }
-
-    for (int i = 0; i < sectionCount; i++)
-    {
-        glm::vec3 x = (unitVector * glm::vec3(i));
-        glm::vec3 placementVector = vertices_in[0] - x;
-
-        glm::vec3 invUnitVector = {-unitVector.z, unitVector.y, unitVector.x};
-
-        // Scene::getInstance()->addLine(placementVector, {placementVector.x, placementVector.y+5, placementVector.z})
-        //     ->SetColour(BLUE);
-
-        // Zone vertices
-        glm::vec3 one = placementVector;
-        glm::vec3 two = placementVector-unitVector;
-        glm::vec3 three = placementVector-invUnitVector;
-        glm::vec3 four = placementVector-unitVector-invUnitVector;
-
-        // This does this as an example
-        // 0 1 2 3 4 5 6 7 8 9 10 11 12 13 // Position
-        // 0 1 2 3 4 5 5 5 5 4 3  2  1  0  // Deepness
-        int deepness = 0;
-        constexpr int maxDeepness = 8;
-        // If first half
-        if (i < sectionCount/2)
-        {
-            if (i < maxDeepness) {deepness = i;}
-            else {deepness = maxDeepness;}
-        }
-        // Second half
-        else {
-            if ((sectionCount - i) > maxDeepness) {deepness = maxDeepness;}
-            else {deepness = sectionCount - (i+1);}
-        }
-
-        areasForPlacement.push_back({placementVector, 
-                                     false, 
-                                     this->GetZoneAngle()+flip,
-                                     {one, two, four, three},
-                                     deepness});
-        // Scene::getInstance()->addLine(placementVector, {placementVector.x, placementVector.y+deepness+2, placementVector.z})
-        //      ->SetColour(BLUE);
-
-    }
+    // Determine the placement areas along the zone, replacing the ones from before the road was moved
+    areasForPlacement = CalculatePlacementAreas(vertices_in, width_in);
 }
 
 
@@ -102,28 +52,7 @@ PlacementArea const* RoadZoneObject::GetValidPlacement(void)
 // Checks if two orienteted rectangles collide, using SAT - seperate axis theorem
 bool RoadZoneObject::Intersects(const std::array<glm::vec3, 4>& boundingBox) const
 {
-    // First we check the axis of our zone
-    std::array<glm::vec3, 8> axis;
-
-    size_t i;
-    // Get all 4 edges of both rectangles
-    for (i = 0; i < 4; i++)
-    {
-        // Get each vector of each edge and then get its perits adjacent one and then put them into a bix array
-        axis[i] = glm::normalize(getPerpendicularXZ(vertices[(i + 1) % 4] - vertices[i]));
-        axis[i+4] = glm::normalize(getPerpendicularXZ(boundingBox[(i + 1) % 4] - boundingBox[i]));
-    }
-
-    for (i = 0; i < 8; i++)
-    {
-        if (!projectionOverlap(vertices, boundingBox, axis[i]))
-        {
-            return false;
-        }
-    }
-
-    // Does not intersect
-    return true;
+    return intersectsSAT(vertices, boundingBox);
 }
 
 void RoadZoneObject::SetColour(glm::vec3 colour)
@@ -146,7 +75,7 @@ bool RoadZoneObject::IsUsable(void) const
 
 float RoadZoneObject::GetZoneAngle(void)
 {    
-    return glm::atan((vertices[1].z - vertices[0].z)/(vertices[1].x - vertices[0].x));
+    return CalculateZoneAngle(vertices);
 }
 
 
@@ -111,9 +111,14 @@ glm::mat4 SpriteObject::GetModelMatrix(void)
     }
     else
     {
-        return glm::mat4(1.0f) * getPositionMat4(position) * getRotateMat4(rotation) * BaseObject::getScaleMat4(scaleScalar) * BaseObject::getScaleMat4(scale) / getPositionMat4(objectOriginPosition);
+        return ComputeModelMatrix(GetInstanceTransform());
     }
 }
+
+InstanceTransform SpriteObject::GetInstanceTransform(void) const
+{
+    return {position, rotation, scaleScalar * glm::vec3(scale, 1.0f), objectOriginPosition};
+}
 const SpriteRenderer* SpriteObject::GetSpriteRenderer(void) const
 {
     return spriteRenderer;
@@ -177,6 +182,11 @@ std::string const& SpriteObject::GetSpritePath()
 {
     return spritePath;
 }
+
+AssetId SpriteObject::GetSpriteAssetId() const
+{
+    return spriteRenderer->GetTextureAssetId();
+}
 // ImGui Definitions
 
 bool& SpriteObject::GetIsBillboardImGui()
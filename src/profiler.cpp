@@ -0,0 +1,246 @@
+#include <profiler.hpp>
+#include <config.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+Profiler* Profiler::pInstance{nullptr};
+
+std::atomic<bool> Profiler::recording{false};
+std::atomic<uint32_t> Profiler::session{0};
+std::atomic<int64_t> Profiler::sessionStart{0};
+
+thread_local Profiler::ThreadBuffer* Profiler::threadBuffer{nullptr};
+
+Profiler* Profiler::getInstance()
+{
+    if (pInstance == nullptr)
+    {
+        pInstance = new Profiler();
+    }
+    return pInstance;
+}
+
+
+int64_t Profiler::now(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+Profiler::ThreadBuffer* Profiler::getThreadBuffer(void)
+{
+    if (threadBuffer == nullptr)
+    {
+        Profiler* profiler = getInstance();
+        std::lock_guard<std::mutex> lock(profiler->buffersMutex);
+        profiler->buffers.push_back(std::make_unique<ThreadBuffer>());
+        threadBuffer = profiler->buffers.back().get();
+        threadBuffer->threadId = profiler->buffers.size() - 1;
+    }
+
+    const uint32_t current = session.load(std::memory_order_acquire);
+    if (threadBuffer->session != current)
+    {
+        std::lock_guard<std::mutex> lock(threadBuffer->mutex);
+        threadBuffer->spans.clear();
+        threadBuffer->openSpans.clear();
+        threadBuffer->session = current;
+    }
+    return threadBuffer;
+}
+
+
+void Profiler::BeginSession(void)
+{
+    // Threads clear their buffers the next time they record
+    sessionStart.store(now(), std::memory_order_relaxed);
+    session.fetch_add(1, std::memory_order_release);
+    recording.store(true, std::memory_order_release);
+}
+
+
+void Profiler::AddCounter(const char* name, int64_t value)
+{
+    if (!IsRecording())
+        return;
+
+    ThreadBuffer* buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    if (buffer->openSpans.empty())
+        return;
+    buffer->spans[buffer->openSpans.back()].counters.push_back({name, value});
+}
+
+
+// Span names are literals from the code but are escaped anyway so the trace always parses
+static void writeJsonString(std::ostream& out, const char* text)
+{
+    out << '"';
+    for (const char* c = text; *c != '\0'; c++)
+    {
+        if (*c == '"' || *c == '\\') { out << '\\'; }
+        out << *c;
+    }
+    out << '"';
+}
+
+
+// Trace timestamps are in microseconds, written with the nanoseconds as decimals
+static void writeMicroseconds(std::ostream& out, int64_t nanoseconds)
+{
+    out << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000;
+}
+
+
+void Profiler::EndSession(void)
+{
+    recording.store(false, std::memory_order_release);
+}
+
+
+bool Profiler::EndSession(const std::string& path)
+{
+    EndSession();
+    const uint32_t current = session.load(std::memory_order_acquire);
+
+    std::ofstream out(path);
+    if (!out.is_open())
+    {
+        LOG(ERROR_SERV(LOG_PROFILER), "Failed to open trace file: " << path);
+        return false;
+    }
+
+    size_t spanCount = 0;
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+
+    std::lock_guard<std::mutex> buffersLock(buffersMutex);
+    for (auto& buffer : buffers)
+    {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        if (buffer->session != current || buffer->spans.empty())
+            continue;
+
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+            << ",\"args\":{\"name\":\"Thread " << buffer->threadId << "\"}}";
+        first = false;
+
+        for (const Span& span : buffer->spans)
+        {
+            if (span.duration < 0)
+                continue;
+
+            out << ",\n{\"name\":";
+            writeJsonString(out, span.name);
+            out << ",\"cat\":\"generator\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"ts\":";
+            writeMicroseconds(out, span.start);
+            out << ",\"dur\":";
+            writeMicroseconds(out, span.duration);
+            out << ",\"args\":{";
+            for (size_t i = 0; i < span.counters.size(); i++)
+            {
+                out << (i == 0 ? "" : ",");
+                writeJsonString(out, span.counters[i].name);
+                out << ':' << span.counters[i].value;
+            }
+            out << "}}";
+            spanCount++;
+        }
+    }
+    out << "\n]}\n";
+
+    LOG(STATUS_SERV(LOG_PROFILER), spanCount << " spans written to " << path);
+    return true;
+}
+
+
+void Profiler::addSpanTotals(const std::vector<Span>& spans, std::vector<SpanTotal>& totals)
+{
+    for (const Span& span : spans)
+    {
+        if (span.duration < 0)
+            continue;
+
+        // Few distinct names, a linear search is fine
+        auto it = std::find_if(totals.begin(), totals.end(), [&](const SpanTotal& total) { return total.name == span.name; });
+        if (it == totals.end())
+        {
+            totals.push_back({span.name, 0, 0});
+            it = totals.end() - 1;
+        }
+        it->count++;
+        it->duration += span.duration;
+    }
+}
+
+
+std::vector<Profiler::SpanTotal> Profiler::GetSpanTotals(void)
+{
+    const uint32_t current = session.load(std::memory_order_acquire);
+    std::vector<SpanTotal> totals;
+
+    std::lock_guard<std::mutex> buffersLock(buffersMutex);
+    for (auto& buffer : buffers)
+    {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        if (buffer->session != current)
+            continue;
+
+        addSpanTotals(buffer->spans, totals);
+    }
+    return totals;
+}
+
+
+std::vector<Profiler::SpanTotal> Profiler::TakeThreadSpanTotals(void)
+{
+    std::vector<SpanTotal> totals;
+    if (!IsRecording())
+        return totals;
+
+    ThreadBuffer* buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    addSpanTotals(buffer->spans, totals);
+
+    // Open spans are referred to by index, they would be lost with the rest
+    if (buffer->openSpans.empty())
+    {
+        buffer->spans.clear();
+    }
+    return totals;
+}
+
+
+ProfileScope::ProfileScope(const char* name)
+{
+    if (!Profiler::IsRecording())
+        return;
+
+    buffer = Profiler::getThreadBuffer();
+    session = buffer->session;
+    const int64_t start = Profiler::now() - Profiler::sessionStart.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    buffer->openSpans.push_back(buffer->spans.size());
+    buffer->spans.push_back({name, start, -1, {}});
+}
+
+
+ProfileScope::~ProfileScope()
+{
+    if (buffer == nullptr)
+        return;
+
+    const int64_t end = Profiler::now() - Profiler::sessionStart.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    // A new session began while the span was open, its buffer was cleared
+    if (buffer->session != session || buffer->openSpans.empty())
+        return;
+
+    Profiler::Span& span = buffer->spans[buffer->openSpans.back()];
+    span.duration = end - span.start;
+    buffer->openSpans.pop_back();
+}
@@ -5,6 +5,8 @@
 // Get roads
 #include <scene.hpp>
 #include <cassert>
+#include <algorithm>
+#include <functional>
 #include <camera.hpp>
 #include <resourceManager.hpp>
 
@@ -29,84 +31,83 @@ template class InstanceRenderer<ModelObject*>;
 template<typename T>
 void InstanceRenderer<T>::Append(T object)
 {
-    // Add object to list
+    // Add object to list, the object keeps its slot so it is found again without a search
+    object->SetInstanceIndex(objects.size());
     objects.push_back({static_cast<void*>(object), objects.size()});
     
-    glm::mat4 mat = object->GetModelMatrix();
-    // Push back matrix
-    for (int i = 0; i < 4; i++)
-    {
-        matrices.insert(matrices.end(), {mat[i].x, mat[i].y, mat[i].z, mat[i].w});
-    }
+    // Room for its matrix, written from the transform before the next draw
+    matrices.resize(matrices.size() + 16);
+    transforms.Add(object->GetInstanceTransform());
 }
 
 template<typename T>
-void InstanceRenderer<T>::Remove(T object)
+void InstanceRenderer<T>::AppendStatic(T type, const float* instanceMatrices, size_t count)
 {
-    // TODO
-    // Edge case, when the last item is removed, must be dealt with by the caller (scene.remove objecet)
+    if (staticType == nullptr)
+        staticType = type;
 
-    // Find the address
-    auto iter = std::find_if(objects.begin(), 
-        objects.end(), [&](const InstanceObject& iObject)
-    {
-        return (static_cast<void*>(object) == iObject.address);
-    });
+    // After the static instances already added, the objects keep their matrices at the end
+    matrices.insert(matrices.begin() + staticCount*16, instanceMatrices, instanceMatrices + count*16);
+    staticCount += count;
+}
 
-    // If found remove the matrices and objects
-    if (iter != objects.end())
-    {
-        // Remove and update iterator
-        iter = objects.erase(iter);
+template<typename T>
+size_t InstanceRenderer<T>::find(T object) const
+{
+    const size_t index = object->GetInstanceIndex();
+    if (index < objects.size() && objects[index].address == static_cast<void*>(object))
+        return index;
+    return Object::noInstanceIndex;
+}
 
-        // Remove the 16 floats of the matrix
-        size_t index = std::distance(objects.begin(), iter);
-        matrices.erase(matrices.begin() + (index*16), matrices.begin() + (index+1)*16);
+template<typename T>
+void InstanceRenderer<T>::Remove(T object)
+{
+    const size_t index = find(object);
+    if (index == Object::noInstanceIndex)
+    {
+        LOG(WARN, "InstanceRenderer::Remove() not found object.");
+        return;
+    }
 
-        // TODO REMOVE once we know it passes
-        assert(matrices.size() % 16 == 0);
+    // The last object takes the slot, only it has to be told where it moved to
+    const size_t last = objects.size() - 1;
+    if (index != last)
+    {
+        objects[index] = {objects[last].address, index};
+        static_cast<T>(objects[index].address)->SetInstanceIndex(index);
 
-        // Update renderIDs of all objects after this removal
-        for (unsigned int i = std::distance(objects.begin(), iter); i < objects.size(); i++)
-        {
-            objects.at(i).renderID--;
-        }
-    }
-    else {
-        LOG(WARN, "InstanceRenderer::Remove() not found object.");
+        const auto lastMatrix = matrices.begin() + (staticCount + last)*16;
+        std::copy(lastMatrix, lastMatrix + 16, matrices.begin() + (staticCount + index)*16);
     }
+    objects.pop_back();
+    matrices.resize(matrices.size() - 16);
+    transforms.SwapRemove(index);
+    object->SetInstanceIndex(Object::noInstanceIndex);
 }
 
 template<typename T>
 void InstanceRenderer<T>::Clear()
 {
+    for (const InstanceObject& instance : objects)
+    {
+        static_cast<T>(instance.address)->SetInstanceIndex(Object::noInstanceIndex);
+    }
     objects.clear();
     matrices.clear();
+    transforms.Clear();
+    staticType = nullptr;
+    staticCount = 0;
 }
 
 template<typename T>
 void InstanceRenderer<T>::Update(T object)
 {
-    // Find the address
-    auto iter = std::find_if(objects.begin(), 
-        objects.end(), [&](const InstanceObject& iObject)
-    {
-        return (static_cast<void*>(object) == iObject.address);
-    });
-
-    // Found
-    if (iter != objects.end())
+    // Found, the matrix is written with the other changed ones before the next draw
+    const size_t index = find(object);
+    if (index != Object::noInstanceIndex)
     {
-        glm::mat4 mat = object->GetModelMatrix();
-        std::vector<float> matrixNew;
-        for (int i = 0; i < 4; i++)
-        {
-            matrixNew.insert(matrixNew.end(), {mat[i].x, mat[i].y, mat[i].z, mat[i].w});
-        }
-        // Replace the matrix data
-        size_t index = std::distance(objects.begin(), iter);
-        
-        std::copy(matrixNew.begin(), matrixNew.end(), matrices.begin() + (index*16));
+        transforms.Set(index, object->GetInstanceTransform());
     }
     else {
         LOG(WARN, "InstanceRenderer::Update() not found object.");
@@ -116,19 +117,11 @@ void InstanceRenderer<T>::Update(T object)
 template<typename T>
 void InstanceRenderer<T>::UpdateAll()
 {
-    // Faster to do this rather than calling this->update(T)
-    for (size_t i = 0; i < objects.size(); i++)
+    // Every transform is read again and every matrix written in one batch
+    transforms.SetAll([this](size_t i)
     {
-        glm::mat4 mat = static_cast<ModelObject*>(objects[i].address)->GetModelMatrix();
-        std::vector<float> matrixNew;
-        for (int j = 0; j < 4; j++)
-        {
-            matrixNew.insert(matrixNew.end(), {mat[j].x, mat[j].y, mat[j].z, mat[j].w});
-        }
-
-        // Replace the matrix data
-        std::copy(matrixNew.begin(), matrixNew.end(), matrices.begin() + (i*16));
-    }
+        return static_cast<T>(objects[i].address)->GetInstanceTransform();
+    }, matrices.data() + staticCount*16);
 }
 
 template<typename T>
@@ -137,9 +130,10 @@ void InstanceRenderer<T>::Draw()
     // ModelObject - 
     Camera* camera = Camera::getInstance();
 
-    if (objects.size() != 0)
+    if (size() != 0)
     {
-        static_cast<T>(objects[0].address)->DrawInstances(camera->GetViewMatrix(), 
+        transforms.ComputeDirty(matrices.data() + staticCount*16);
+        GetInstanceType()->DrawInstances(camera->GetViewMatrix(), 
             camera->GetProjectionMatrix(), &matrices);
     }
     else 
@@ -149,12 +143,19 @@ void InstanceRenderer<T>::Draw()
     }
 }
 
+template<typename T>
+const std::vector<float>& InstanceRenderer<T>::GetMatrices(void)
+{
+    transforms.ComputeDirty(matrices.data() + staticCount*16);
+    return matrices;
+}
+
 template<typename T>
 const T InstanceRenderer<T>::GetInstanceType(void) const
 {
-    // Return nullptr if we dont have anything
+    // Static type or nullptr if we dont have any objects
     if (objects.size() == 0)
-        return nullptr;
+        return staticType;
 
     return static_cast<T>(objects[0].address);
 }
@@ -162,7 +163,7 @@ const T InstanceRenderer<T>::GetInstanceType(void) const
 template<typename T>
 const size_t InstanceRenderer<T>::size(void) const
 {
-    return objects.size();
+    return objects.size() + staticCount;
 }
 
 //#########################
@@ -184,58 +185,136 @@ BatchRenderer::~BatchRenderer()
     delete(EBO);
 }
 
-void BatchRenderer::UpdateAll(void)
-{
-    // Gives new renderIDs
-    auto roads = Scene::getInstance()->GetRoadObjects();
+// Slots the buffers are first made with, they double when full
+constexpr size_t roadBatchMinCapacity = 256;
 
-    // Create buffers based on this size
- 
+void BatchRenderer::allocate(size_t roadCount)
+{
+    capacity = std::max(roadCount, roadBatchMinCapacity);
 
-    // VBO bytes -> number of roads * maxvertices * 3(xyz) * sizeof(float)
-    // EBO bytes -> sizeof(unsigned int) * maxindices
     VertexBufferLayout vbl;
     vbl.AddFloat(3); // aPos
     vbl.AddFloat(3); // normal
 
+    // The element buffer binding is part of the VAO, bind it first
     VAO->Bind();
-    // Buffer for all roads
-    VBO->CreateBuffer(ROAD_MAX_VERT_BUFFER_SIZE_BYTES * roads.size());
+    VBO->CreateBuffer(ROAD_MAX_VERT_BUFFER_SIZE_BYTES * capacity);
+    EBO->CreateBuffer(ROAD_MAX_INDICES * capacity);
 
+    // Bind it all to VAO
+    VAO->AddBuffer(VBO, &vbl);
+}
 
-    std::vector<unsigned int> updatedIndices;
-    
-    // No class for indirect buffer so manually here
-    for (unsigned int i = 0; i < roads.size(); i++)
+void BatchRenderer::writeSlots(size_t first, size_t last)
+{
+    if (first >= last)
+        return;
+
+    std::vector<float> vertices((last - first) * ROAD_MAX_VERT_BUFFER_SIZE, 0.0f);
+    std::vector<unsigned int> indices((last - first) * ROAD_MAX_INDICES);
+    for (size_t i = first; i < last; i++)
     {
-        const auto roadRenderer = roads[i]->GetRoadRenderer();
-        unsigned int indexCount = roads[i]->GetRoadRenderer()->GetIndices()->size();
-        
-        roads[i]->GetRoadRenderer()->SetBatchRenderID(i);
-        int renderID = i;
+        const auto roadRenderer = slots[i]->GetRoadRenderer();
+        const std::vector<float>& roadVertices = *roadRenderer->GetVertices();
+        const std::vector<unsigned int>& roadIndices = *roadRenderer->GetIndices();
 
         // Check that the road is valid
-        assert(indexCount <= ROAD_MAX_INDICES);
-        assert(renderID >= 0);
-
-        // Enter data into VBO and EBO
-        VBO->UpdateBuffer(roadRenderer->GetVertices()->data(), i * ROAD_MAX_VERT_BUFFER_SIZE_BYTES, roadRenderer->GetVertices()->size() * sizeof(float));
-        // EBO NEEDS TO BE UPDATED WITH THE VERTEX INDEX FOR EACH ROAD, THEY WILL BE ALL STARING AT 0
-        
-        // For each index in roadRenderer, itterate by ROAD_MAX_INDICES*i
-        for (auto a : *roadRenderer->GetIndices())
+        assert(roadVertices.size() <= ROAD_MAX_VERT_BUFFER_SIZE);
+        assert(roadIndices.size() <= ROAD_MAX_INDICES);
+
+        std::copy(roadVertices.begin(), roadVertices.end(), vertices.begin() + (i - first) * ROAD_MAX_VERT_BUFFER_SIZE);
+
+        // Indices of a road start at 0, offset them to its slot. The rest of the slot repeats its first vertex
+        const unsigned int firstVertex = i * ROAD_MAX_VERTICES;
+        auto slotIndices = indices.begin() + (i - first) * ROAD_MAX_INDICES;
+        for (unsigned int index : roadIndices)
         {
-            updatedIndices.push_back(a += (i*ROAD_MAX_VERTICES));
+            *slotIndices++ = index + firstVertex;
         }
+        std::fill(slotIndices, indices.begin() + (i - first + 1) * ROAD_MAX_INDICES, firstVertex);
     }
-    EBO->SetData(updatedIndices.data(), updatedIndices.size());
 
-    // Bind it all to VAO
-    VAO->AddBuffer(VBO, &vbl);
-    
+    VAO->Bind();
+    VBO->UpdateBuffer(vertices.data(), first * ROAD_MAX_VERT_BUFFER_SIZE_BYTES, vertices.size() * sizeof(float));
+    EBO->UpdateBuffer(indices.data(), first * ROAD_MAX_INDICES * sizeof(unsigned int), indices.size() * sizeof(unsigned int));
+
     GLenum error;
     while ((error = glGetError()) != GL_NO_ERROR) {
-        LOG(ERROR, "OpenGL UpdateAll() Error: " << error);
+        LOG(ERROR, "OpenGL writeSlots() Error: " << error);
+    }
+}
+
+void BatchRenderer::UpdateAll(void)
+{
+    // Gives new renderIDs
+    auto const& roads = Scene::getInstance()->GetRoadObjects();
+    slots.assign(roads.begin(), roads.end());
+    for (unsigned int i = 0; i < slots.size(); i++)
+    {
+        slots[i]->GetRoadRenderer()->SetBatchRenderID(i);
+    }
+
+    allocate(slots.size());
+    writeSlots(0, slots.size());
+}
+
+void BatchRenderer::Append(const std::vector<RoadObject*>& roads)
+{
+    const size_t first = slots.size();
+    for (RoadObject* road : roads)
+    {
+        road->GetRoadRenderer()->SetBatchRenderID(slots.size());
+        slots.push_back(road);
+    }
+
+    // Growing the buffers loses their contents, every road is written again
+    if (slots.size() > capacity)
+    {
+        allocate(std::max(slots.size(), capacity * 2));
+        writeSlots(0, slots.size());
+    }
+    else
+    {
+        writeSlots(first, slots.size());
+    }
+}
+
+void BatchRenderer::Remove(const std::vector<RoadObject*>& roads)
+{
+    std::vector<size_t> removed;
+    for (RoadObject* road : roads)
+    {
+        const int slot = road->GetRoadRenderer()->GetBatchRenderID();
+        if (slot >= 0 && static_cast<size_t>(slot) < slots.size() && slots[slot] == road)
+        {
+            removed.push_back(slot);
+        }
+    }
+
+    // Highest slot first, so the last road is never one still to be removed
+    std::sort(removed.begin(), removed.end(), std::greater<size_t>());
+    std::vector<size_t> moved;
+    for (size_t slot : removed)
+    {
+        const size_t last = slots.size() - 1;
+        if (slot != last)
+        {
+            slots[slot] = slots[last];
+            slots[slot]->GetRoadRenderer()->SetBatchRenderID(slot);
+            moved.push_back(slot);
+        }
+        slots.pop_back();
+    }
+
+    // Upload the slots that got a road, runs of them in one go. A slot past the end was moved again later
+    std::sort(moved.begin(), moved.end());
+    size_t run = 0;
+    while (run < moved.size() && moved[run] < slots.size())
+    {
+        size_t end = run + 1;
+        while (end < moved.size() && moved[end] == moved[end-1] + 1 && moved[end] < slots.size()) { end++; }
+        writeSlots(moved[run], moved[end-1] + 1);
+        run = end;
     }
 }
 
@@ -289,7 +368,7 @@ void BatchRenderer::DrawBatch(glm::mat4 view, glm::mat4 projection) const
     // Bind all relevant buffers before draw
     VAO->Bind();
     EBO->Bind();
-    glDrawElements(GL_TRIANGLES, EBO->GetCount(), GL_UNSIGNED_INT, nullptr);
+    glDrawElements(GL_TRIANGLES, slots.size() * ROAD_MAX_INDICES, GL_UNSIGNED_INT, nullptr);
 
     GLenum error;
     while ((error = glGetError()) != GL_NO_ERROR) {
@@ -301,7 +380,13 @@ void BatchRenderer::DrawBatch(glm::mat4 view, glm::mat4 projection) const
 void BatchRenderer::Delete(const RoadObject* road)
 {
     Scene::getInstance()->removeRoad(*road);
-    this->UpdateAll();
+
+    // Only the road that takes its slot is uploaded
+    auto slot = std::find(slots.begin(), slots.end(), road);
+    if (slot != slots.end())
+    {
+        Remove({*slot});
+    }
 }
 
 //######################
@@ -4,6 +4,7 @@
 #include <resourceManager.hpp>
 #include <renderer.hpp>
 #include <bounding_box.hpp>
+#include <roadGeometry.hpp>
 
 #include <vector>
 
@@ -104,22 +105,13 @@ void Road::UpdateVertices(glm::vec3 point_a, glm::vec3 point_b, float width)
     // Draw 3 boxes for the road
     ////////////////////////////
     */
-    // dont include Y component into unit vector as it causes the road to thin when normalizing
-    glm::vec3 unitVecAB = glm::normalize(glm::vec3{point_b.x, 0, point_b.z} - glm::vec3{point_a.x, 0, point_a.z});
-    glm::vec3 invUnitVecAB = glm::vec3{-unitVecAB.z, unitVecAB.y, unitVecAB.x};
-    
-    glm::vec3 point_a_offset = {point_a.x + (radius * unitVecAB.x), point_a.y, point_a.z + (radius * unitVecAB.z)};
-    glm::vec3 leftA = point_a_offset + (invUnitVecAB * radius);
-    glm::vec3 rightA = point_a_offset - (invUnitVecAB * radius);
-
-    glm::vec3 point_b_offset = {point_b.x - (radius * unitVecAB.x), point_b.y, point_b.z - (radius * unitVecAB.z)};
-    glm::vec3 leftB = point_b_offset + (invUnitVecAB * radius);
-    glm::vec3 rightB = point_b_offset - (invUnitVecAB * radius);
-
-    glm::vec3 three = {leftA.x, point_a.y, leftA.z};
-    glm::vec3 four = {rightA.x, point_a.y, rightA.z};
-    glm::vec3 five = {leftB.x, point_b.y, leftB.z};
-    glm::vec3 six = {rightB.x, point_b.y, rightB.z};
+    // OBB and zone vertices are shared with the headless generator
+    RoadGeometry geometry = CalculateRoadGeometry(point_a, point_b, width);
+
+    glm::vec3 three = geometry.leftZone[0];
+    glm::vec3 four = geometry.rightZone[1];
+    glm::vec3 five = geometry.leftZone[1];
+    glm::vec3 six = geometry.rightZone[0];
     
     // 1, 2, 7, 8 are all overlapped points and so we reuse them from the semi-circles
 
@@ -144,54 +136,18 @@ void Road::UpdateVertices(glm::vec3 point_a, glm::vec3 point_b, float width)
     verts.insert(verts.end(), {five.x, five.y, five.z});                        // 5
     verts.insert(verts.end(), {fiveNormal.x, fiveNormal.y, fiveNormal.z});
 
-    verts.insert(verts.end(), {rightB.x, point_b.y, rightB.z});                 // 6
+    verts.insert(verts.end(), {six.x, six.y, six.z});                           // 6
     verts.insert(verts.end(), {sixNormal.x, sixNormal.y, sixNormal.z});
 
-    //
-    // 4 vertices that fully encapsulate the road on the xz plane
-    //
-    glm::vec3 point_b_offset_out = {point_b.x + (radius * unitVecAB.x), point_b.y, point_b.z + (radius * unitVecAB.z)};
-    glm::vec3 topRightPoint = point_b_offset_out + (invUnitVecAB * radius);
-    glm::vec3 bottomRightPoint = point_b_offset_out - (invUnitVecAB * radius);
-
-    glm::vec3 point_a_offset_out = {point_a.x - (radius * unitVecAB.x), point_a.y, point_a.z - (radius * unitVecAB.z)};
-    glm::vec3 topLeftPoint = point_a_offset_out + (invUnitVecAB * radius);
-    glm::vec3 bottomLeftPoint = point_a_offset_out - (invUnitVecAB * radius);
-
-    this->road_OBB = {topRightPoint, bottomRightPoint, bottomLeftPoint, topLeftPoint};
-    
-    // this->road_obb_min = {INFINITY, INFINITY, INFINITY};
-    // this->road_obb_max = {-INFINITY, -INFINITY, -INFINITY};
-    // // Get road OBB min and max for bounding box testing
-    // for (int i = 0; i < 4; i++)
-    // {
-    //     if (road_OBB[i].x < road_obb_min.x) road_obb_min.x = road_OBB[i].x; 
-    //     if (road_OBB[i].y < road_obb_min.y) road_obb_min.y = road_OBB[i].y; 
-    //     if (road_OBB[i].z < road_obb_min.z) road_obb_min.z = road_OBB[i].z;
-    //
-    //     if (road_OBB[i].x > road_obb_max.x) road_obb_max.x = road_OBB[i].x;
-    //     if (road_OBB[i].y > road_obb_max.y) road_obb_max.y = road_OBB[i].y;
-    //     if (road_OBB[i].z > road_obb_max.z) road_obb_max.z = road_OBB[i].z;
-    // }
+    this->road_OBB = geometry.obb;
 
     this->road_bb->Update(this->road_OBB[0]);
     this->road_bb->Update(this->road_OBB[1]);
     this->road_bb->Update(this->road_OBB[2]);
     this->road_bb->Update(this->road_OBB[3]);
     
-    // 
-    // We need the 8 vertices that will define out left and right zone for the zoning algorithm
-    // Radius*2 as we want the area besides to be as big as road, this can be changed later
-    //
-    // left zone, 3 and 5 used
-    glm::vec3 leftZone_topLeft = three + (invUnitVecAB * (radius*2));
-    glm::vec3 leftZone_topRight = five + (invUnitVecAB * (radius*2));
-    this->road_left_zone_vertices = {three, five, leftZone_topRight, leftZone_topLeft};
-
-    // Right zone, 4 and 6 used
-    glm::vec3 rightZone_bottomLeft = four - (invUnitVecAB * (radius*2));
-    glm::vec3 rightZone_bottomRight = six - (invUnitVecAB * (radius*2));
-    this->road_right_zone_vertices = {six, four, rightZone_bottomLeft, rightZone_bottomRight};
+    this->road_left_zone_vertices = geometry.leftZone;
+    this->road_right_zone_vertices = geometry.rightZone;
     
     std::vector<unsigned int> indices;
     
@@ -57,6 +57,7 @@ SpriteRenderer::SpriteRenderer(Shader* spriteShader_in, const std::string& filen
 
     // textureID to be stored
     spriteTextureID = textureInfo->textureID;
+    textureAssetId = textureInfo->assetId;
     // shader to be stored
     spriteShader = spriteShader_in;
 
@@ -0,0 +1,271 @@
+#include <transformStore.hpp>
+#include <threadPool.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Blocks handed to a thread at a time, and the fewest blocks worth splitting over the pool
+constexpr size_t blocksPerTask = 64;
+constexpr size_t parallelBlockCount = 4 * blocksPerTask;
+
+#if defined(__AVX2__)
+
+typedef __m256 Lanes;
+constexpr int laneWidth = 8;
+inline Lanes loadLanes(const float* p) { return _mm256_load_ps(p); }
+inline void storeLanes(float* p, Lanes value) { _mm256_store_ps(p, value); }
+inline Lanes zeroLanes(void) { return _mm256_setzero_ps(); }
+inline Lanes add(Lanes a, Lanes b) { return _mm256_add_ps(a, b); }
+inline Lanes sub(Lanes a, Lanes b) { return _mm256_sub_ps(a, b); }
+inline Lanes mul(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+
+#elif defined(__SSE2__)
+
+typedef __m128 Lanes;
+constexpr int laneWidth = 4;
+inline Lanes loadLanes(const float* p) { return _mm_load_ps(p); }
+inline void storeLanes(float* p, Lanes value) { _mm_store_ps(p, value); }
+inline Lanes zeroLanes(void) { return _mm_setzero_ps(); }
+inline Lanes add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+inline Lanes sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+inline Lanes mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+
+#else
+
+typedef float Lanes;
+constexpr int laneWidth = 1;
+inline Lanes loadLanes(const float* p) { return *p; }
+inline void storeLanes(float* p, Lanes value) { *p = value; }
+inline Lanes zeroLanes(void) { return 0.0f; }
+inline Lanes add(Lanes a, Lanes b) { return a + b; }
+inline Lanes sub(Lanes a, Lanes b) { return a - b; }
+inline Lanes mul(Lanes a, Lanes b) { return a * b; }
+
+#endif
+
+// Elements the kernel computes, rows 0 to 2 of each column in column major order.
+// Row 3 is always 0, 0, 0, 1
+constexpr int computedElements[12] = {0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14};
+
+
+void TransformBlock::Set(int lane, const InstanceTransform& transform)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        position[i][lane] = transform.position[i];
+        sinAngle[i][lane] = std::sin(transform.rotation[i]);
+        cosAngle[i][lane] = std::cos(transform.rotation[i]);
+        scale[i][lane] = transform.scale[i];
+        origin[i][lane] = transform.origin[i];
+    }
+}
+
+
+void TransformBlock::CopyLane(int from, const TransformBlock& source, int to)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        position[i][to] = source.position[i][from];
+        sinAngle[i][to] = source.sinAngle[i][from];
+        cosAngle[i][to] = source.cosAngle[i][from];
+        scale[i][to] = source.scale[i][from];
+        origin[i][to] = source.origin[i][from];
+    }
+}
+
+
+// Model matrices of the 8 lanes of a block, out[i][lane] is element computedElements[i]
+static void computeBlock(const TransformBlock& block, float (*out)[TransformBlock::lanes])
+{
+    for (int l = 0; l < TransformBlock::lanes; l += laneWidth)
+    {
+        const Lanes sinX = loadLanes(block.sinAngle[0] + l), sinY = loadLanes(block.sinAngle[1] + l), sinZ = loadLanes(block.sinAngle[2] + l);
+        const Lanes cosX = loadLanes(block.cosAngle[0] + l), cosY = loadLanes(block.cosAngle[1] + l), cosZ = loadLanes(block.cosAngle[2] + l);
+        const Lanes scaleX = loadLanes(block.scale[0] + l), scaleY = loadLanes(block.scale[1] + l), scaleZ = loadLanes(block.scale[2] + l);
+
+        // Columns of getRotateMat4, each scaled by its axis
+        const Lanes cosZsinY = mul(cosZ, sinY), sinZsinY = mul(sinZ, sinY);
+        Lanes m[12];
+        m[0] = mul(mul(cosZ, cosY), scaleX);
+        m[1] = mul(sub(mul(cosZsinY, sinX), mul(sinZ, cosX)), scaleX);
+        m[2] = mul(add(mul(cosZsinY, cosX), mul(sinZ, sinX)), scaleX);
+        m[3] = mul(mul(sinZ, cosY), scaleY);
+        m[4] = mul(add(mul(sinZsinY, sinX), mul(cosZ, cosX)), scaleY);
+        m[5] = mul(sub(mul(sinZsinY, cosX), mul(cosZ, sinX)), scaleY);
+        m[6] = mul(sub(zeroLanes(), sinY), scaleZ);
+        m[7] = mul(mul(cosY, sinX), scaleZ);
+        m[8] = mul(mul(cosY, cosX), scaleZ);
+
+        // Translation, the position less the rotated and scaled origin
+        const Lanes originX = loadLanes(block.origin[0] + l), originY = loadLanes(block.origin[1] + l), originZ = loadLanes(block.origin[2] + l);
+        for (int row = 0; row < 3; row++)
+        {
+            const Lanes rotatedOrigin = add(add(mul(m[row], originX), mul(m[3 + row], originY)), mul(m[6 + row], originZ));
+            m[9 + row] = sub(loadLanes(block.position[row] + l), rotatedOrigin);
+        }
+
+        for (int i = 0; i < 12; i++)
+        {
+            storeLanes(out[i] + l, m[i]);
+        }
+    }
+}
+
+
+glm::mat4 ComputeModelMatrix(const InstanceTransform& transform)
+{
+    // Only lane 0 is used, the others are zero so they compute nothing that could trap
+    TransformBlock block = {};
+    block.Set(0, transform);
+    alignas(32) float out[12][TransformBlock::lanes];
+    computeBlock(block, out);
+
+    glm::mat4 matrix(1.0f);
+    for (int i = 0; i < 12; i++)
+    {
+        matrix[computedElements[i] / 4][computedElements[i] % 4] = out[i][0];
+    }
+    return matrix;
+}
+
+
+void TransformStore::Clear(void)
+{
+    blocks.clear();
+    dirtyLanes.clear();
+    count = 0;
+    anyDirty = false;
+}
+
+
+void TransformStore::Add(const InstanceTransform& transform)
+{
+    const int lane = count % TransformBlock::lanes;
+    if (lane == 0)
+    {
+        blocks.emplace_back();
+        dirtyLanes.push_back(0);
+    }
+    blocks.back().Set(lane, transform);
+    dirtyLanes.back() |= 1 << lane;
+    anyDirty = true;
+    count++;
+}
+
+
+void TransformStore::Set(size_t index, const InstanceTransform& transform)
+{
+    const size_t block = index / TransformBlock::lanes;
+    const int lane = index % TransformBlock::lanes;
+    blocks[block].Set(lane, transform);
+    dirtyLanes[block] |= 1 << lane;
+    anyDirty = true;
+}
+
+
+void TransformStore::SwapRemove(size_t index)
+{
+    // Same as the instance renderer does with its objects and matrices
+    const size_t last = count - 1;
+    const size_t lastBlock = last / TransformBlock::lanes;
+    const int lastLane = last % TransformBlock::lanes;
+    if (index != last)
+    {
+        const size_t block = index / TransformBlock::lanes;
+        const int lane = index % TransformBlock::lanes;
+        blocks[block].CopyLane(lastLane, blocks[lastBlock], lane);
+
+        const uint8_t dirty = (dirtyLanes[lastBlock] >> lastLane) & 1;
+        dirtyLanes[block] = (dirtyLanes[block] & ~(1 << lane)) | (dirty << lane);
+    }
+
+    count--;
+    if (lastLane == 0)
+    {
+        blocks.pop_back();
+        dirtyLanes.pop_back();
+    }
+    else
+    {
+        dirtyLanes[lastBlock] &= ~(1 << lastLane);
+    }
+}
+
+
+void TransformStore::computeBlocks(size_t firstBlock, size_t endBlock, bool dirtyOnly, float* matrices)
+{
+    alignas(32) float out[12][TransformBlock::lanes];
+    for (size_t b = firstBlock; b < endBlock; b++)
+    {
+        if (dirtyOnly && dirtyLanes[b] == 0)
+            continue;
+
+        computeBlock(blocks[b], out);
+        const size_t first = b * TransformBlock::lanes;
+        const int laneCount = std::min<size_t>(TransformBlock::lanes, count - first);
+        for (int lane = 0; lane < laneCount; lane++)
+        {
+            float* matrix = matrices + (first + lane) * 16;
+            for (int i = 0; i < 12; i++)
+            {
+                matrix[computedElements[i]] = out[i][lane];
+            }
+            matrix[3] = matrix[7] = matrix[11] = 0.0f;
+            matrix[15] = 1.0f;
+        }
+        dirtyLanes[b] = 0;
+    }
+}
+
+
+void TransformStore::ComputeDirty(float* matrices)
+{
+    if (!anyDirty)
+        return;
+    anyDirty = false;
+
+    // Clean lanes of a dirty block are written again with the matrix they already have
+    if (blocks.size() < parallelBlockCount)
+    {
+        computeBlocks(0, blocks.size(), true, matrices);
+        return;
+    }
+    const size_t taskCount = (blocks.size() + blocksPerTask - 1) / blocksPerTask;
+    ThreadPool::getInstance()->ParallelFor(taskCount, [&](size_t task)
+    {
+        computeBlocks(task * blocksPerTask, std::min(blocks.size(), (task + 1) * blocksPerTask), true, matrices);
+    });
+}
+
+
+void TransformStore::SetAll(const std::function<InstanceTransform(size_t)>& transform, float* matrices)
+{
+    // Each task reads the transforms of its own blocks and writes their matrices straight away
+    auto setBlocks = [&](size_t firstBlock, size_t endBlock)
+    {
+        const size_t end = std::min(count, endBlock * TransformBlock::lanes);
+        for (size_t i = firstBlock * TransformBlock::lanes; i < end; i++)
+        {
+            blocks[i / TransformBlock::lanes].Set(i % TransformBlock::lanes, transform(i));
+        }
+        computeBlocks(firstBlock, endBlock, false, matrices);
+    };
+
+    anyDirty = false;
+    if (blocks.size() < parallelBlockCount)
+    {
+        setBlocks(0, blocks.size());
+        return;
+    }
+    const size_t taskCount = (blocks.size() + blocksPerTask - 1) / blocksPerTask;
+    ThreadPool::getInstance()->ParallelFor(taskCount, [&](size_t task)
+    {
+        setBlocks(task * blocksPerTask, std::min(blocks.size(), (task + 1) * blocksPerTask));
+    });
+}
@@ -248,6 +248,7 @@ TextureInfo* ResourceManager::LoadTexture(const std::string& textureName, bool f
         texInfo->width = width;
         texInfo->height = height;
         texInfo->fileName = texturePath;
+        texInfo->assetId = InternAssetPath(texturePath);
         
         // Insert into map and return the struct
         texture_map.insert(std::make_pair(texturePath, texInfo));
@@ -273,12 +274,26 @@ Model* ResourceManager::LoadModel(const std::string& modelPath_in, Shader* model
     {
         LOG(STATUS_SERV(LOG_RM), "Loading model : " << modelPath_in);
         Model* model = new Model(modelShader_in, modelPath_in);
+        model->SetAssetId(InternAssetPath(modelPath_in));
         model_map.insert(std::make_pair(modelPath_in, model));
         return model;
     }
 }
 
 
+AssetId ResourceManager::InternAssetPath(const std::string& path)
+{
+    auto it = asset_ids.find(path);
+    if (it != asset_ids.end())
+    {
+        return it->second;
+    }
+    AssetId id = static_cast<AssetId>(asset_ids.size());
+    asset_ids.insert(std::make_pair(path, id));
+    return id;
+}
+
+
 Shader* ResourceManager::LoadModelShader(const ShaderPath* shader_in, const bool instanced)
 {
     
@@ -3,6 +3,7 @@
 #include <road_object.hpp>
 #include <resourceManager.hpp>
 #include <algorithm>
+#include <unordered_set>
 #include <camera.hpp>
 
 Scene* Scene::pInstance{nullptr};
@@ -72,50 +73,71 @@ ModelObject* Scene::addTerrain(const std::string& modelPath_in,
 }
 
 
-void Scene::addModelToInstanceRenderer(ModelObject* modelObject_in,
-                                       const std::string& modelPath_in)
+InstanceRenderer<ModelObject*>* Scene::getOrAddModelInstanceRenderer(AssetId model)
 {
-    bool added = false;
-    // We check all of the instance renderers for a same object
-    for (auto& ir : modelInstanceRenderers)
+    auto it = modelInstanceRendererIds.find(model);
+    if (it != modelInstanceRendererIds.end())
     {
-        // Same model must be added
-        if (ir->GetInstanceType()->GetModelPath() == modelPath_in)
-        {
-            added = true;
-            ir->Append(modelObject_in);
-        }
-    }
-    if (!added)
-    {
-        InstanceRenderer<ModelObject*>* IR = new InstanceRenderer<ModelObject*>(); 
-        IR->Append(modelObject_in);
-        modelInstanceRenderers.push_back(IR);
+        return it->second;
     }
+    InstanceRenderer<ModelObject*>* IR = new InstanceRenderer<ModelObject*>();
+    modelInstanceRenderers.push_back(IR);
+    modelInstanceRendererIds.insert(std::make_pair(model, IR));
+    return IR;
+}
+
+void Scene::addModelToInstanceRenderer(ModelObject* modelObject_in)
+{
+    // Same model must be added
+    getOrAddModelInstanceRenderer(modelObject_in->GetModelAssetId())->Append(modelObject_in);
 }
 
-void Scene::addSpriteToInstanceRenderer(SpriteObject* spriteObject_in,
-                                        const std::string& spritePath_in)
+void Scene::addSpriteToInstanceRenderer(SpriteObject* spriteObject_in)
 {
     // We do not allow billboarded sprites to be instance rendered
     assert(spriteObject_in->GetIsBillboardImGui() == false);
-    
-    bool added = false;
-    // Check all of the instance renderers for the same object
-    for (auto& ir : spriteInstanceRenderers)
+
+    // Same texture must be added
+    const AssetId texture = spriteObject_in->GetSpriteAssetId();
+    auto it = spriteInstanceRendererIds.find(texture);
+    if (it != spriteInstanceRendererIds.end())
     {
-        // We find the model
-        if (ir->GetInstanceType()->GetSpritePath() == spritePath_in)
-        {
-            added = true;
-            ir->Append(spriteObject_in);
-        }
+        it->second->Append(spriteObject_in);
+        return;
     }
-    if (!added)
+    InstanceRenderer<SpriteObject*>* IR = new InstanceRenderer<SpriteObject*>();
+    IR->Append(spriteObject_in);
+    spriteInstanceRenderers.push_back(IR);
+    spriteInstanceRendererIds.insert(std::make_pair(texture, IR));
+}
+
+
+void Scene::removeModelFromInstanceRenderer(ModelObject* modelObject_in)
+{
+    InstanceRenderer<ModelObject*>* ir = this->GetModelInstanceRenderer(modelObject_in);
+    ir->Remove(modelObject_in);
+
+    // If we just removed the last element they we should delete the instance renderer
+    if (ir->size() == 0)
+    {
+        // Find and remove the instance renderer
+        modelInstanceRendererIds.erase(modelObject_in->GetModelAssetId());
+        modelInstanceRenderers.erase(std::find(modelInstanceRenderers.begin(), modelInstanceRenderers.end(), ir));
+        delete(ir);
+    }
+}
+
+
+void Scene::removeSpriteFromInstanceRenderer(SpriteObject* spriteObject_in)
+{
+    InstanceRenderer<SpriteObject*>* ir = this->GetSpriteInstanceRenderer(spriteObject_in);
+    ir->Remove(spriteObject_in);
+
+    if (ir->size() == 0)
     {
-        InstanceRenderer<SpriteObject*>* IR = new InstanceRenderer<SpriteObject*>();
-        IR->Append(spriteObject_in);
-        spriteInstanceRenderers.push_back(IR);
+        spriteInstanceRendererIds.erase(spriteObject_in->GetSpriteAssetId());
+        spriteInstanceRenderers.erase(std::find(spriteInstanceRenderers.begin(), spriteInstanceRenderers.end(), ir));
+        delete(ir);
     }
 }
 
@@ -131,25 +153,13 @@ void Scene::ForceReloadInstanceRendererData(void) const
 
 InstanceRenderer<ModelObject*>* Scene::GetModelInstanceRenderer(ModelObject* object) const
 {
-    for (auto& ir : modelInstanceRenderers)
-    {
-        if (ir->GetInstanceType()->GetModelPath() == object->GetModelPath())
-        {
-            return ir;
-        }
-    }
-    return nullptr;
+    auto it = modelInstanceRendererIds.find(object->GetModelAssetId());
+    return it != modelInstanceRendererIds.end() ? it->second : nullptr;
 }
 InstanceRenderer<SpriteObject*>* Scene::GetSpriteInstanceRenderer(SpriteObject* object) const
 {
-    for (auto& ir : spriteInstanceRenderers)
-    {
-        if (ir->GetInstanceType()->GetSpritePath() == object->GetSpritePath())
-        {
-            return ir;
-        }
-    }
-    return nullptr;
+    auto it = spriteInstanceRendererIds.find(object->GetSpriteAssetId());
+    return it != spriteInstanceRendererIds.end() ? it->second : nullptr;
 }
 
 ModelObject* Scene::addModel(const std::string& modelPath_in,
@@ -159,7 +169,7 @@ ModelObject* Scene::addModel(const std::string& modelPath_in,
     // If we have passed nullptr load default shader
     Shader* shader = ResourceManager::getInstance()->LoadModelShader(shader_in, instanced);
 
-    ModelObject* model = new ModelObject(
+    ModelObject* model = modelPool.Create(
         modelPath_in, shader
     );
     
@@ -167,7 +177,7 @@ ModelObject* Scene::addModel(const std::string& modelPath_in,
     model->SetInstaceRendering(instanced);
     if (instanced)
     {
-        addModelToInstanceRenderer(model, modelPath_in);
+        addModelToInstanceRenderer(model);
     }
 
     scene_model_objects.push_back(model);
@@ -180,6 +190,27 @@ ModelObject* Scene::addModel(const std::string& modelPath_in,
     return model;
 }
 
+void Scene::addModelInstances(const std::string& modelPath_in,
+                              const ShaderPath* shader_in,
+                              const float* matrices,
+                              size_t count)
+{
+    if (count == 0)
+        return;
+
+    // One object of the model is loaded to draw all of its instances, objects in the scene can be deleted so it is not one of them
+    const AssetId model = ResourceManager::getInstance()->InternAssetPath(modelPath_in);
+    ModelObject*& type = instanceTypeObjects[model];
+    if (type == nullptr)
+    {
+        Shader* shader = ResourceManager::getInstance()->LoadModelShader(shader_in, true);
+        type = modelPool.Create(modelPath_in, shader);
+        type->SetInstaceRendering(true);
+    }
+
+    getOrAddModelInstanceRenderer(model)->AppendStatic(type, matrices, count);
+}
+
 // Roads
 RoadObject* Scene::addRoad(glm::vec3 point_a,
                            glm::vec3 point_b,
@@ -194,7 +225,7 @@ RoadObject* Scene::addRoad(glm::vec3 point_a,
         road_width = 0.1;
     }
 
-    RoadObject* road = new RoadObject(
+    RoadObject* road = roadPool.Create(
         point_a, point_b, road_width, shader
     );
 
@@ -217,7 +248,7 @@ SpriteObject* Scene::addSprite(const std::string& spriteTexture_in,
     Shader* shader = ResourceManager::getInstance()->LoadSpriteShader(shader_in, instanced);
 
     // Create sprite, allocate memory and put in list
-    SpriteObject* sprite = new SpriteObject(
+    SpriteObject* sprite = spritePool.Create(
         spriteTexture_in, shader
     );
     scene_sprite_objects.push_back(sprite);
@@ -225,7 +256,7 @@ SpriteObject* Scene::addSprite(const std::string& spriteTexture_in,
     sprite->SetIsInstanceRendered(instanced);
     if (instanced)
     {
-        this->addSpriteToInstanceRenderer(sprite, spriteTexture_in);
+        this->addSpriteToInstanceRenderer(sprite);
     }
 
     spriteCount++;
@@ -319,22 +350,9 @@ void Scene::removeModel(ModelObject& obj)
     std::vector<ModelObject*>::iterator it = std::find(scene_model_objects.begin(), scene_model_objects.end(), &obj);
     if (it != scene_model_objects.end())
     {
-        ModelObject* mobj = *it;
-        if (mobj->GetIsInstanceRendered())
+        if ((*it)->GetIsInstanceRendered())
         {
-            InstanceRenderer<ModelObject*>* ir = this->GetModelInstanceRenderer(mobj);
-            ir->Remove(mobj);
-
-            // If we just removed the last element they we should delete the instance renderer
-            if (ir->size() == 0)
-            {
-                // Find and remove the instance renderer
-                for (size_t i = 0; i < modelInstanceRenderers.size(); i++)
-                {
-                    if (modelInstanceRenderers[i] == ir)
-                        modelInstanceRenderers.erase(modelInstanceRenderers.begin() + i);
-                }
-            }
+            removeModelFromInstanceRenderer(*it);
         }
         scene_model_objects.erase(it);
     }
@@ -345,20 +363,9 @@ void Scene::removeSprite(SpriteObject& obj)
     auto it = std::find(scene_sprite_objects.begin(), scene_sprite_objects.end(), &obj);
     if (it != scene_sprite_objects.end())
     {
-        SpriteObject* sobj = *it; 
-        if (sobj->GetIsInstanceRendered())
+        if ((*it)->GetIsInstanceRendered())
         {
-            InstanceRenderer<SpriteObject*>* ir = this->GetSpriteInstanceRenderer(sobj);
-            ir->Remove(sobj);
-
-            if (ir->size() == 0)
-            {
-                for (size_t i = 0; i < spriteInstanceRenderers.size(); i++)
-                {
-                    if (spriteInstanceRenderers[i] == ir)
-                        spriteInstanceRenderers.erase(spriteInstanceRenderers.begin() + i);
-                }
-            }
+            removeSpriteFromInstanceRenderer(*it);
         }
         scene_sprite_objects.erase(it);
     }    
@@ -401,6 +408,76 @@ void Scene::removeRoad(const RoadObject& obj)
 }
 
 
+void Scene::destroyModel(ModelObject* obj)
+{
+    removeModel(*obj);
+    modelPool.Release(obj);
+}
+
+void Scene::destroySprite(SpriteObject* obj)
+{
+    removeSprite(*obj);
+    spritePool.Release(obj);
+}
+
+void Scene::destroyRoad(RoadObject* obj)
+{
+    removeRoad(*obj);
+    roadPool.Release(obj);
+}
+
+
+// Objects of the list that are in the scene are moved to the end of it, keeping the order of the rest.
+// Returns where they start
+template<typename T>
+static typename std::vector<T*>::iterator partitionRemoved(std::vector<T*>& sceneObjects, const std::vector<T*>& objs)
+{
+    const std::unordered_set<T*> removed(objs.begin(), objs.end());
+    return std::stable_partition(sceneObjects.begin(), sceneObjects.end(), [&removed](T* obj)
+    {
+        return removed.count(obj) == 0;
+    });
+}
+
+void Scene::destroyModels(const std::vector<ModelObject*>& objs)
+{
+    auto removed = partitionRemoved(scene_model_objects, objs);
+    for (auto it = removed; it != scene_model_objects.end(); it++)
+    {
+        if ((*it)->GetIsInstanceRendered())
+        {
+            removeModelFromInstanceRenderer(*it);
+        }
+        modelPool.Release(*it);
+    }
+    scene_model_objects.erase(removed, scene_model_objects.end());
+}
+
+void Scene::destroySprites(const std::vector<SpriteObject*>& objs)
+{
+    auto removed = partitionRemoved(scene_sprite_objects, objs);
+    for (auto it = removed; it != scene_sprite_objects.end(); it++)
+    {
+        if ((*it)->GetIsInstanceRendered())
+        {
+            removeSpriteFromInstanceRenderer(*it);
+        }
+        spritePool.Release(*it);
+    }
+    scene_sprite_objects.erase(removed, scene_sprite_objects.end());
+}
+
+void Scene::destroyRoads(const std::vector<RoadObject*>& objs)
+{
+    auto removed = partitionRemoved(scene_road_objects, objs);
+    for (auto it = removed; it != scene_road_objects.end(); it++)
+    {
+        roadPool.Release(*it);
+    }
+    scene_road_objects.erase(removed, scene_road_objects.end());
+}
+
+
 // Method implementations for removing all objects from each vector
 // None of the removeAll.. methods are thread safe
 void Scene::removeAllModels(void)
@@ -410,24 +487,30 @@ void Scene::removeAllModels(void)
     {
         ir->Clear();
         delete(ir);
-        modelInstanceRenderers.clear();
     }
+    modelInstanceRenderers.clear();
+    modelInstanceRendererIds.clear();
 
-    for (auto& obj : scene_model_objects)
-    {
-        delete(obj);
-    }
-    // Then empty the vector
+    // Then destroy every model at once, removed ones and instance types included
     scene_model_objects.clear();
+    instanceTypeObjects.clear();
+    modelPool.Clear();
 }
 
 void Scene::removeAllSprites(void)
 {
-    for (auto& obj : scene_sprite_objects)
+    // remove all sprites from the instance renderer
+    for (auto& ir : spriteInstanceRenderers)
     {
-        delete(obj);
+        ir->Clear();
+        delete(ir);
     }
+    spriteInstanceRenderers.clear();
+    spriteInstanceRendererIds.clear();
+
+    // Then destroy every sprite at once
     scene_sprite_objects.clear();
+    spritePool.Clear();
 }
 
 void Scene::removeAllLines(void)
@@ -459,11 +542,8 @@ void Scene::removeAllDirectionalLights(void)
 
 void Scene::removeAllRoads(void)
 {
-    for (auto& obj : scene_road_objects)
-    {
-        delete(obj);
-    }
     this->scene_road_objects.clear();
+    roadPool.Clear();
     this->roadBatchRenderer->UpdateAll();
 }
 
@@ -474,6 +554,7 @@ void Scene::removeAllInstanceRenderers(void)
         delete(a);
     }
     modelInstanceRenderers.clear();
+    modelInstanceRendererIds.clear();
     
     // for (auto& a : spriteInstanceRenderers)
     // {
@@ -0,0 +1,214 @@
+#include <threadPool.hpp>
+#include <config.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+ThreadPool* ThreadPool::pInstance{nullptr};
+
+// Set on pool threads so nested ParallelFor calls run inline
+static thread_local bool isPoolWorker = false;
+
+ThreadPool* ThreadPool::getInstance()
+{
+    if (pInstance == nullptr)
+    {
+        pInstance = new ThreadPool();
+    }
+    return pInstance;
+}
+
+
+ThreadPool::ThreadPool()
+{
+    SetThreadCount(0);
+}
+
+
+ThreadPool::~ThreadPool()
+{
+    stopWorkers();
+}
+
+
+void ThreadPool::SetThreadCount(size_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::thread::hardware_concurrency();
+        // hardware_concurrency can return 0 if unknown
+        if (threadCount == 0) { threadCount = 1; }
+    }
+
+    stopWorkers();
+    startWorkers(threadCount - 1);
+    LOG(STATUS_SERV(LOG_POOL), "Running with " << threadCount << " threads");
+}
+
+
+void ThreadPool::startWorkers(size_t workerCount)
+{
+    stopping = false;
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; i++)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+
+void ThreadPool::stopWorkers(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(taskMutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    workers.clear();
+}
+
+
+void ThreadPool::workerLoop(void)
+{
+    isPoolWorker = true;
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(taskMutex);
+            taskAvailable.wait(lock, [this]{ return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty())
+                return;
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& body)
+{
+    if (count == 0)
+        return;
+
+    // Nothing to split or already on a pool thread, run inline
+    if (count == 1 || workers.empty() || isPoolWorker)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            body(i);
+        }
+        return;
+    }
+
+    // Shared between the caller and the helpers. A helper queued behind other tasks (chunks from
+    // Submit) may only start after the caller ran every index, so it can outlive this call: it
+    // checks in before touching body and the caller closes the job once it is done
+    struct Job
+    {
+        std::atomic<size_t> nextIndex{0};
+        size_t helpersRunning = 0;
+        bool closed = false;
+        std::exception_ptr exception;
+        std::mutex jobMutex;
+        std::condition_variable helpersDone;
+    };
+    auto job = std::make_shared<Job>();
+
+    auto runIndices = [&job = *job, &body, count]()
+    {
+        size_t i;
+        while ((i = job.nextIndex.fetch_add(1)) < count)
+        {
+            try
+            {
+                body(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(job.jobMutex);
+                if (!job.exception) { job.exception = std::current_exception(); }
+                // Stop handing out indices
+                job.nextIndex.store(count);
+            }
+        }
+    };
+
+    // The caller takes part so only count-1 helpers are useful
+    const size_t helperCount = std::min(workers.size(), count - 1);
+    {
+        std::lock_guard<std::mutex> lock(taskMutex);
+        for (size_t h = 0; h < helperCount; h++)
+        {
+            tasks.emplace_back([job, runIndices]()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(job->jobMutex);
+                    if (job->closed)
+                        return;
+                    job->helpersRunning++;
+                }
+                runIndices();
+                std::lock_guard<std::mutex> lock(job->jobMutex);
+                if (--job->helpersRunning == 0)
+                {
+                    job->helpersDone.notify_one();
+                }
+            });
+        }
+    }
+    taskAvailable.notify_all();
+
+    runIndices();
+
+    // Every index is taken, wait for the helpers still running one and turn away the rest
+    std::unique_lock<std::mutex> lock(job->jobMutex);
+    job->closed = true;
+    job->helpersDone.wait(lock, [&job]{ return job->helpersRunning == 0; });
+
+    if (job->exception)
+    {
+        std::rethrow_exception(job->exception);
+    }
+}
+
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+    auto guardedTask = [task = std::move(task)]()
+    {
+        try
+        {
+            task();
+        }
+        catch (const std::exception& e)
+        {
+            LOG(ERROR_SERV(LOG_POOL), "Submitted task failed: " << e.what());
+        }
+        catch (...)
+        {
+            LOG(ERROR_SERV(LOG_POOL), "Submitted task failed");
+        }
+    };
+
+    if (workers.empty())
+    {
+        guardedTask();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(taskMutex);
+        tasks.emplace_back(std::move(guardedTask));
+    }
+    taskAvailable.notify_one();
+}